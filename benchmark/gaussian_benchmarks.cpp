@@ -0,0 +1,849 @@
+/*
+BSD 3-Clause License
+
+Copyright (c) 2018, eelcoder
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+* Redistributions of source code must retain the above copyright notice, this
+list of conditions and the following disclaimer.
+
+* Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentation
+and/or other materials provided with the distribution.
+
+* Neither the name of the copyright holder nor the names of its
+contributors may be used to endorse or promote products derived from
+this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+         SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+#include "pandora/filters/gaussian.h"
+#include "pandora/filters/gaussian_planner.h"
+#include "pandora/filters/gaussian_pyramid.h"
+#include "pandora/filters/gaussian_scale_space.h"
+#include "pandora/filters/unsharp_mask.h"
+
+#if defined(PANDORA_X86) && defined(_MSC_VER)
+#include <intrin.h>
+#elif defined(PANDORA_X86)
+#include <x86intrin.h>
+#endif
+
+/**
+ * Benchmarks of the gaussian filters, in the spirit of Google Benchmark.
+ *
+ * Options :
+ *     --benchmark_filter=<text>     : only run the benchmarks whose name contains <text>.
+ *     --benchmark_out=<file>        : write the results to <file>, in JSON.
+ *     --benchmark_min_time=<secs>   : minimum measured time of each benchmark (default 0.2).
+ *     --benchmark_list              : list the benchmarks without running them.
+ *     --benchmark_wisdom=<file>     : load the plans of the auto tuned filter from <file>, and save them back.
+ *     --accuracy                    : print the accuracy of the gaussian approximations instead.
+ *
+ * Each result reports the time of a frame, the throughput in megapixels per second, the cycles per
+ * pixel (time stamp counter, x86 only) and the effective memory bandwidth : one byte read and one byte
+ * written per pixel, the minimum any implementation has to move.
+ * The batch benchmarks filter a batch of thumbnails per iteration : the time is the one of the whole
+ * batch, the throughput is the aggregate one, in megapixels and in images per second.
+ */
+namespace
+{
+    struct image_size
+    {
+        const char* name;
+        int width;
+        int height;
+    };
+    
+    struct benchmark_result
+    {
+        std::string name;
+        std::string implementation;
+        image_size size;
+        int kernel_size;
+        float sigma;
+        int threads;
+        int batch_size;
+        int iterations;
+        double milliseconds;
+        double megapixels_per_second;
+        double images_per_second;
+        double cycles_per_pixel;
+        double gigabytes_per_second;
+    };
+    
+    /**
+     * \brief one benchmark : a filter applied to a frame, or to a batch of batch_size frames,
+     *        created when the benchmark runs.
+     */
+    struct benchmark_case
+    {
+        std::string name;
+        std::string implementation;
+        image_size size;
+        int kernel_size;
+        float sigma;
+        int threads;
+        int batch_size;
+        std::function<std::function<void(const pandora::image8u&,pandora::image8u&)>()> make_filter;
+    };
+    
+    /**
+     * \brief fill an image with uniform noise.
+     *
+     * \param[out] image to fill.
+     */
+    void fill_with_noise(pandora::image8u &image)
+    {
+        std::default_random_engine generator;
+        std::uniform_int_distribution<int> dist(0,255);
+        
+        for (auto& pixel_value : image)
+        {
+            pixel_value = static_cast<pandora::image8u::value_type>(dist(generator));
+        }
+    }
+    
+    /**
+     * \brief time stamp counter, 0 when not available.
+     */
+    inline unsigned long long cycle_counter()
+    {
+#if defined(PANDORA_X86)
+        return __rdtsc();
+#else
+        return 0;
+#endif
+    }
+    
+    /**
+     * \brief run a benchmark until the minimum time is reached.
+     *
+     * \param[in] benchmark.
+     * \param[in] minimum measured time, in seconds.
+     * \return timings of the benchmark.
+     */
+    benchmark_result run(const benchmark_case &benchmark,double minimum_time)
+    {
+        pandora::image8u input_image(benchmark.size.width,benchmark.size.height,1,1,0);
+        pandora::image8u output_image(benchmark.size.width,benchmark.size.height,1,1,0);
+        fill_with_noise(input_image);
+        
+        auto filter = benchmark.make_filter();
+        
+        //warm up the caches and the allocations, and estimate the number of iterations
+        auto start = std::chrono::steady_clock::now();
+        filter(input_image,output_image);
+        double warm_up = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        const int iterations = std::max(1,std::min(10000,static_cast<int>(std::ceil(minimum_time / std::max(warm_up,1e-9)))));
+        
+        start = std::chrono::steady_clock::now();
+        const unsigned long long start_cycles = cycle_counter();
+        for (int i = 0; i < iterations; ++i)
+        {
+            filter(input_image,output_image);
+        }
+        const unsigned long long stop_cycles = cycle_counter();
+        const auto stop = std::chrono::steady_clock::now();
+        
+        const double pixels = static_cast<double>(benchmark.size.width) * benchmark.size.height * benchmark.batch_size;
+        const double seconds = std::chrono::duration<double>(stop - start).count() / iterations;
+        
+        benchmark_result result;
+        result.name = benchmark.name;
+        result.implementation = benchmark.implementation;
+        result.size = benchmark.size;
+        result.kernel_size = benchmark.kernel_size;
+        result.sigma = benchmark.sigma;
+        result.threads = benchmark.threads;
+        result.batch_size = benchmark.batch_size;
+        result.iterations = iterations;
+        result.milliseconds = seconds * 1000.0;
+        result.megapixels_per_second = pixels / seconds / 1e6;
+        result.images_per_second = benchmark.batch_size / seconds;
+        result.cycles_per_pixel = static_cast<double>(stop_cycles - start_cycles) / iterations / pixels;
+        result.gigabytes_per_second = 2.0 * pixels / seconds / 1e9;
+        return result;
+    }
+    
+    /**
+     * \brief write the results in the JSON layout of Google Benchmark.
+     *
+     * \param[in] output file.
+     * \param[in] results.
+     */
+    bool write_json(const char* path,const std::vector<benchmark_result> &results)
+    {
+        std::FILE* file = std::fopen(path,"w");
+        if (file == nullptr)
+        {
+            return false;
+        }
+        
+        static const char* simd_names[] = {"scalar","sse4.1","avx2"};
+        
+        std::fprintf(file,"{\n  \"context\": {\n");
+        std::fprintf(file,"    \"simd_level\": \"%s\",\n",simd_names[static_cast<int>(pandora::cpu_simd_level())]);
+        std::fprintf(file,"    \"num_cpus\": %u\n  },\n",std::thread::hardware_concurrency());
+        std::fprintf(file,"  \"benchmarks\": [\n");
+        for (std::size_t i = 0; i < results.size(); ++i)
+        {
+            const auto& result = results[i];
+            std::fprintf(file,"    {\n");
+            std::fprintf(file,"      \"name\": \"%s\",\n",result.name.c_str());
+            std::fprintf(file,"      \"implementation\": \"%s\",\n",result.implementation.c_str());
+            std::fprintf(file,"      \"width\": %d,\n      \"height\": %d,\n",result.size.width,result.size.height);
+            std::fprintf(file,"      \"kernel_size\": %d,\n      \"sigma\": %g,\n",result.kernel_size,result.sigma);
+            std::fprintf(file,"      \"threads\": %d,\n      \"batch_size\": %d,\n",result.threads,result.batch_size);
+            std::fprintf(file,"      \"iterations\": %d,\n",result.iterations);
+            std::fprintf(file,"      \"real_time\": %.6f,\n      \"time_unit\": \"ms\",\n",result.milliseconds);
+            std::fprintf(file,"      \"megapixels_per_second\": %.3f,\n",result.megapixels_per_second);
+            std::fprintf(file,"      \"images_per_second\": %.1f,\n",result.images_per_second);
+            std::fprintf(file,"      \"cycles_per_pixel\": %.3f,\n",result.cycles_per_pixel);
+            std::fprintf(file,"      \"bytes_per_second\": %.0f\n",result.gigabytes_per_second * 1e9);
+            std::fprintf(file,"    }%s\n",(i + 1 < results.size()) ? "," : "");
+        }
+        std::fprintf(file,"  ]\n}\n");
+        
+        std::fclose(file);
+        return true;
+    }
+    
+    /**
+     * \brief apply a filter, on the thread pool when there is one.
+     */
+    template<typename filter_type>
+    void apply_filter(filter_type &filter,const pandora::image8u &input_image,pandora::image8u &output_image,
+                      pandora::thread_pool* pool)
+    {
+        if (pool != nullptr)
+        {
+            filter(input_image,output_image,*pool);
+        }
+        else
+        {
+            filter(input_image,output_image);
+        }
+    }
+    
+    /**
+     * \brief register a filter over a frame size, kernel size and sigma.
+     *
+     * \param[in,out] benchmarks.
+     * \param[in] implementation name.
+     * \param[in] image size.
+     * \param[in] kernel size.
+     * \param[in] gaussian sigma.
+     * \param[in] thread pool, null for the single threaded filter.
+     */
+    template<typename filter_type>
+    void add(std::vector<benchmark_case> &benchmarks,const char* implementation,const image_size &size,
+             int kernel_size,float sigma,pandora::thread_pool* pool = nullptr)
+    {
+        char name[128];
+        const int threads = (pool != nullptr) ? pool->size() : 1;
+        std::snprintf(name,sizeof(name),"%s/%s/k%d/s%.3g/t%d",implementation,size.name,kernel_size,sigma,threads);
+        
+        benchmark_case benchmark{name,implementation,size,kernel_size,sigma,threads,1,nullptr};
+        benchmark.make_filter = [size,kernel_size,sigma,pool]()
+        {
+            auto filter = std::make_shared<filter_type>(size.width,size.height,kernel_size,sigma);
+            return std::function<void(const pandora::image8u&,pandora::image8u&)>(
+                [filter,pool](const pandora::image8u &input_image,pandora::image8u &output_image)
+                {
+                    apply_filter(*filter,input_image,output_image,pool);
+                });
+        };
+        benchmarks.push_back(benchmark);
+    }
+    
+    /**
+     * \brief noisy input images and their output images, shared by the calls of a batch benchmark.
+     */
+    struct thumbnails
+    {
+        thumbnails(const image_size &size,int count)
+        {
+            for (int i = 0; i < count; ++i)
+            {
+                input_images.emplace_back(size.width,size.height,1,1,0);
+                output_images.emplace_back(size.width,size.height,1,1,0);
+                fill_with_noise(input_images.back());
+            }
+            for (int i = 0; i < count; ++i)
+            {
+                pairs.emplace_back(&input_images[i],&output_images[i]);
+            }
+        }
+        
+        std::vector<pandora::image8u> input_images;
+        std::vector<pandora::image8u> output_images;
+        std::vector<std::pair<const pandora::image8u*,pandora::image8u*>> pairs;
+    };
+    
+    /**
+     * \brief register a filter over a batch of thumbnails filtered in one call, the filter keeps its scratch
+     *        buffers from one thumbnail to the next.
+     *
+     * \param[in,out] benchmarks.
+     * \param[in] implementation name.
+     * \param[in] thumbnail size.
+     * \param[in] number of thumbnails.
+     * \param[in] kernel size.
+     * \param[in] gaussian sigma.
+     * \param[in] thread pool, null for the single threaded batch.
+     */
+    template<typename filter_type>
+    void add_batch(std::vector<benchmark_case> &benchmarks,const char* implementation,const image_size &size,int batch_size,
+                   int kernel_size,float sigma,pandora::thread_pool* pool = nullptr)
+    {
+        char name[128];
+        const int threads = (pool != nullptr) ? pool->size() : 1;
+        std::snprintf(name,sizeof(name),"batch/%s/%sx%d/k%d/s%.3g/t%d",implementation,size.name,batch_size,kernel_size,sigma,threads);
+        
+        benchmark_case benchmark{name,implementation,size,kernel_size,sigma,threads,batch_size,nullptr};
+        benchmark.make_filter = [size,batch_size,kernel_size,sigma,pool]()
+        {
+            auto filter = std::make_shared<filter_type>(size.width,size.height,kernel_size,sigma);
+            auto images = std::make_shared<thumbnails>(size,batch_size);
+            return std::function<void(const pandora::image8u&,pandora::image8u&)>(
+                [filter,images,pool](const pandora::image8u&,pandora::image8u&)
+                {
+                    const int count = static_cast<int>(images->pairs.size());
+                    if (pool != nullptr)
+                    {
+                        filter->batch(images->pairs.data(),count,*pool);
+                    }
+                    else
+                    {
+                        filter->batch(images->pairs.data(),count);
+                    }
+                });
+        };
+        benchmarks.push_back(benchmark);
+    }
+    
+    /**
+     * \brief register the same batch of thumbnails filtered one call at a time, with a filter constructed
+     *        per thumbnail : the per call overhead the batch removes.
+     */
+    template<typename filter_type>
+    void add_unbatched(std::vector<benchmark_case> &benchmarks,const char* implementation,const image_size &size,int batch_size,
+                       int kernel_size,float sigma)
+    {
+        char name[128];
+        std::snprintf(name,sizeof(name),"batch/%s/%sx%d/k%d/s%.3g/per_image",implementation,size.name,batch_size,kernel_size,sigma);
+        
+        benchmark_case benchmark{name,implementation,size,kernel_size,sigma,1,batch_size,nullptr};
+        benchmark.make_filter = [size,batch_size,kernel_size,sigma]()
+        {
+            auto images = std::make_shared<thumbnails>(size,batch_size);
+            return std::function<void(const pandora::image8u&,pandora::image8u&)>(
+                [images,size,kernel_size,sigma](const pandora::image8u&,pandora::image8u&)
+                {
+                    for (auto& image : images->pairs)
+                    {
+                        filter_type filter(size.width,size.height,kernel_size,sigma);
+                        filter(*image.first,*image.second);
+                    }
+                });
+        };
+        benchmarks.push_back(benchmark);
+    }
+    
+    /**
+     * \brief register the pyramid of a frame, the blur and the decimation fused.
+     *
+     * \param[in,out] benchmarks.
+     * \param[in] frame size.
+     * \param[in] number of levels.
+     * \param[in] kernel size.
+     * \param[in] gaussian sigma.
+     * \param[in] thread pool, null for the single threaded pyramid.
+     */
+    void add_pyramid(std::vector<benchmark_case> &benchmarks,const image_size &size,int level_count,int kernel_size,float sigma,
+                     pandora::thread_pool* pool = nullptr)
+    {
+        char name[128];
+        const int threads = (pool != nullptr) ? pool->size() : 1;
+        std::snprintf(name,sizeof(name),"pyramid/pandora::pyramid/%s/l%d/k%d/s%.3g/t%d",size.name,level_count,kernel_size,sigma,threads);
+        
+        benchmark_case benchmark{name,"pandora::pyramid",size,kernel_size,sigma,threads,1,nullptr};
+        benchmark.make_filter = [level_count,kernel_size,sigma,pool]()
+        {
+            auto pyramid = std::make_shared<pandora::pyramid>(level_count,kernel_size,sigma);
+            return std::function<void(const pandora::image8u&,pandora::image8u&)>(
+                [pyramid,pool](const pandora::image8u &input_image,pandora::image8u&)
+                {
+                    if (pool != nullptr)
+                    {
+                        pyramid->build(input_image,*pool);
+                    }
+                    else
+                    {
+                        pyramid->build(input_image);
+                    }
+                });
+        };
+        benchmarks.push_back(benchmark);
+    }
+    
+    /**
+     * \brief register the same pyramid built by blurring each level and resizing it with CImg.
+     */
+    void add_blur_resize_pyramid(std::vector<benchmark_case> &benchmarks,const image_size &size,int level_count,int kernel_size,float sigma)
+    {
+        char name[128];
+        std::snprintf(name,sizeof(name),"pyramid/blur_resize/%s/l%d/k%d/s%.3g/t1",size.name,level_count,kernel_size,sigma);
+        
+        benchmark_case benchmark{name,"gaussian_simd_filter+resize",size,kernel_size,sigma,1,1,nullptr};
+        benchmark.make_filter = [size,level_count,kernel_size,sigma]()
+        {
+            //the filters and the blurred images of the levels are built once, like the ones of the fused pyramid
+            auto filters = std::make_shared<std::vector<pandora::gaussian_simd_filter>>();
+            auto blurred_images = std::make_shared<std::vector<pandora::image8u>>();
+            int width = size.width;
+            int height = size.height;
+            for (int i = 1; i < level_count; ++i)
+            {
+                filters->emplace_back(width,height,kernel_size,sigma);
+                blurred_images->emplace_back(width,height,1,1,0);
+                width = (width+1)/2;
+                height = (height+1)/2;
+            }
+            
+            auto levels = std::make_shared<std::vector<pandora::image8u>>(level_count);
+            return std::function<void(const pandora::image8u&,pandora::image8u&)>(
+                [filters,blurred_images,levels](const pandora::image8u &input_image,pandora::image8u&)
+                {
+                    (*levels)[0] = input_image;
+                    for (std::size_t i = 1; i < levels->size(); ++i)
+                    {
+                        const auto& previous = (*levels)[i-1];
+                        auto& blurred_image = (*blurred_images)[i-1];
+                        (*filters)[i-1](previous,blurred_image);
+                        (*levels)[i] = blurred_image.get_resize((previous.width()+1)/2,(previous.height()+1)/2,1,1,1);
+                    }
+                });
+        };
+        benchmarks.push_back(benchmark);
+    }
+    
+    /**
+     * \brief register the float scale space of a frame, each level blurred from the previous one
+     *        with the incremental sigma and the differences of gaussians computed in the same pass.
+     *
+     * \param[in,out] benchmarks.
+     * \param[in] frame size.
+     * \param[in] number of levels.
+     * \param[in] sigma of the first level.
+     * \param[in] ratio of the sigmas of two consecutive levels.
+     */
+    void add_scale_space(std::vector<benchmark_case> &benchmarks,const image_size &size,int level_count,float sigma,float scale_ratio)
+    {
+        char name[128];
+        std::snprintf(name,sizeof(name),"scale_space/pandora::scale_space/%s/l%d/s%.3g/t1",size.name,level_count,sigma);
+        
+        benchmark_case benchmark{name,"pandora::scale_space",size,0,sigma,1,1,nullptr};
+        benchmark.make_filter = [level_count,sigma,scale_ratio]()
+        {
+            auto scale_space = std::make_shared<pandora::scale_space>(level_count,sigma,scale_ratio);
+            auto float_image = std::make_shared<pandora::image32f>();
+            return std::function<void(const pandora::image8u&,pandora::image8u&)>(
+                [scale_space,float_image](const pandora::image8u &input_image,pandora::image8u&)
+                {
+                    *float_image = input_image;
+                    scale_space->build(*float_image);
+                });
+        };
+        benchmarks.push_back(benchmark);
+    }
+    
+    /**
+     * \brief register the same scale space with each level blurred directly from the input with its full sigma.
+     */
+    void add_direct_scale_space(std::vector<benchmark_case> &benchmarks,const image_size &size,int level_count,float sigma,float scale_ratio)
+    {
+        char name[128];
+        std::snprintf(name,sizeof(name),"scale_space/direct_blur/%s/l%d/s%.3g/t1",size.name,level_count,sigma);
+        
+        benchmark_case benchmark{name,"basic_gaussian_simd_filter<float>",size,0,sigma,1,1,nullptr};
+        benchmark.make_filter = [size,level_count,sigma,scale_ratio]()
+        {
+            //the filters and the images of the levels are built once, like the ones of the incremental scale space
+            auto filters = std::make_shared<std::vector<pandora::basic_gaussian_simd_filter<float>>>();
+            float level_sigma = sigma;
+            for (int i = 0; i < level_count; ++i, level_sigma *= scale_ratio)
+            {
+                const int kernel_size = 2*static_cast<int>(std::ceil(3*level_sigma))+1;
+                filters->emplace_back(size.width,size.height,kernel_size,level_sigma);
+            }
+            
+            auto levels = std::make_shared<std::vector<pandora::image32f>>(level_count,pandora::image32f(size.width,size.height,1,1,0));
+            auto differences = std::make_shared<std::vector<pandora::image32f>>(level_count-1,pandora::image32f(size.width,size.height,1,1,0));
+            auto float_image = std::make_shared<pandora::image32f>();
+            return std::function<void(const pandora::image8u&,pandora::image8u&)>(
+                [filters,levels,differences,float_image](const pandora::image8u &input_image,pandora::image8u&)
+                {
+                    *float_image = input_image;
+                    for (std::size_t i = 0; i < levels->size(); ++i)
+                    {
+                        (*filters)[i](*float_image,(*levels)[i]);
+                        if (i > 0)
+                        {
+                            auto& difference = (*differences)[i-1];
+                            difference = (*levels)[i];
+                            difference -= (*levels)[i-1];
+                        }
+                    }
+                });
+        };
+        benchmarks.push_back(benchmark);
+    }
+    
+    /**
+     * \brief register the unsharp mask of a frame, the blur and the sharpening fused.
+     *
+     * \param[in,out] benchmarks.
+     * \param[in] frame size.
+     * \param[in] kernel size.
+     * \param[in] gaussian sigma.
+     * \param[in] amount of sharpening.
+     * \param[in] threshold.
+     */
+    void add_unsharp_mask(std::vector<benchmark_case> &benchmarks,const image_size &size,int kernel_size,float sigma,float amount,float threshold)
+    {
+        char name[128];
+        std::snprintf(name,sizeof(name),"unsharp_mask/pandora::unsharp_mask_filter/%s/k%d/s%.3g/t1",size.name,kernel_size,sigma);
+        
+        benchmark_case benchmark{name,"pandora::unsharp_mask_filter",size,kernel_size,sigma,1,1,nullptr};
+        benchmark.make_filter = [kernel_size,sigma,amount,threshold]()
+        {
+            auto filter = std::make_shared<pandora::unsharp_mask_filter>(kernel_size,sigma,amount,threshold);
+            return std::function<void(const pandora::image8u&,pandora::image8u&)>(
+                [filter](const pandora::image8u &input_image,pandora::image8u &output_image)
+                {
+                    filter->apply(input_image,output_image);
+                });
+        };
+        benchmarks.push_back(benchmark);
+    }
+    
+    /**
+     * \brief register the same sharpening as a blurred image followed by a vectorized pass combining it with the input.
+     */
+    void add_blur_sharpen(std::vector<benchmark_case> &benchmarks,const image_size &size,int kernel_size,float sigma,float amount,float threshold)
+    {
+        char name[128];
+        std::snprintf(name,sizeof(name),"unsharp_mask/blur_sharpen/%s/k%d/s%.3g/t1",size.name,kernel_size,sigma);
+        
+        benchmark_case benchmark{name,"gaussian_simd_filter+sharpen",size,kernel_size,sigma,1,1,nullptr};
+        benchmark.make_filter = [size,kernel_size,sigma,amount,threshold]()
+        {
+            auto filter = std::make_shared<pandora::gaussian_simd_filter>(size.width,size.height,kernel_size,sigma);
+            auto blurred_image = std::make_shared<pandora::image8u>(size.width,size.height,1,1,0);
+            return std::function<void(const pandora::image8u&,pandora::image8u &output_image)>(
+                [filter,blurred_image,amount,threshold](const pandora::image8u &input_image,pandora::image8u &output_image)
+                {
+                    (*filter)(input_image,*blurred_image);
+                    pandora::filter::details::sharpen_row(pandora::cpu_simd_level(),input_image.data(),blurred_image->data(),
+                                                          static_cast<int>(input_image.size()),amount,threshold,output_image.data());
+                });
+        };
+        benchmarks.push_back(benchmark);
+    }
+    
+    /**
+     * \brief the naive filter only has a (kernel size, sigma) constructor.
+     */
+    struct naive_filter : pandora::gaussian_naive_filter
+    {
+        naive_filter(int /*width*/,int /*height*/,int kernel_size,float sigma):
+            pandora::gaussian_naive_filter(kernel_size,sigma)
+        {
+        }
+    };
+    
+    /**
+     * \brief planner shared by the auto tuned filters.
+     */
+    pandora::filter::gaussian_planner& planner()
+    {
+        static pandora::filter::gaussian_planner shared_planner;
+        return shared_planner;
+    }
+    
+    /**
+     * \brief the auto tuned filter, planned when the benchmark creates it (outside of the timed loop).
+     */
+    struct auto_filter : pandora::gaussian_auto_filter
+    {
+        auto_filter(int width,int height,int kernel_size,float sigma):
+            pandora::gaussian_auto_filter(planner(),width,height,kernel_size,sigma)
+        {
+        }
+        
+        using pandora::gaussian_auto_filter::operator();
+        
+        //only registered single threaded, the thread pool is part of the plan
+        void operator()(const pandora::image8u &input_image,pandora::image8u &output_image,pandora::thread_pool&)
+        {
+            (*this)(input_image,output_image);
+        }
+    };
+    
+    /**
+     * \brief print the maximum and mean absolute difference between a filter and the naive filter
+     *        with a kernel covering +-3 sigma.
+     *
+     * \param[in] report name.
+     * \param[in] gaussian sigma.
+     */
+    template<typename filter_type>
+    void report_accuracy(const char* name,float sigma)
+    {
+        constexpr int width = 320;
+        constexpr int height = 240;
+        const int kernel_diameter = 2*static_cast<int>(std::ceil(3*sigma))+1;
+        
+        pandora::image8u input_image(width,height,1,1,0);
+        pandora::image8u reference_image(width,height,1,1,0);
+        pandora::image8u output_image(width,height,1,1,0);
+        fill_with_noise(input_image);
+        
+        pandora::gaussian_naive_filter naive_filter(kernel_diameter,sigma);
+        naive_filter(input_image,reference_image);
+        
+        filter_type filter(width,height,kernel_diameter,sigma);
+        filter(input_image,output_image);
+        
+        int maximum_error = 0;
+        double sum_error = 0;
+        for (int i = 0; i < static_cast<int>(output_image.size()); ++i)
+        {
+            const int error = std::abs(output_image[i] - reference_image[i]);
+            maximum_error = std::max(maximum_error,error);
+            sum_error += error;
+        }
+        
+        std::printf("%-32s sigma %-4g max error %3d mean error %6.3f\n",name,sigma,maximum_error,sum_error / output_image.size());
+    }
+    
+    /**
+     * \brief value of a --name=value option.
+     *
+     * \return true if the argument is the option.
+     */
+    bool parse_option(const char* argument,const char* option,std::string &value)
+    {
+        const std::size_t length = std::strlen(option);
+        if (std::strncmp(argument,option,length) == 0 && argument[length] == '=')
+        {
+            value = argument + length + 1;
+            return true;
+        }
+        return false;
+    }
+}
+
+int main(int argc,char** argv)
+{
+    std::string filter_text;
+    std::string output_path;
+    std::string minimum_time_text = "0.2";
+    std::string wisdom_path;
+    bool list_only = false;
+    bool accuracy = false;
+    
+    for (int i = 1; i < argc; ++i)
+    {
+        if (parse_option(argv[i],"--benchmark_filter",filter_text) ||
+            parse_option(argv[i],"--benchmark_out",output_path) ||
+            parse_option(argv[i],"--benchmark_min_time",minimum_time_text) ||
+            parse_option(argv[i],"--benchmark_wisdom",wisdom_path))
+        {
+            continue;
+        }
+        if (std::strcmp(argv[i],"--benchmark_list") == 0)
+        {
+            list_only = true;
+            continue;
+        }
+        if (std::strcmp(argv[i],"--accuracy") == 0)
+        {
+            accuracy = true;
+            continue;
+        }
+        std::fprintf(stderr,"unknown option %s\n",argv[i]);
+        return 1;
+    }
+    
+    if (accuracy)
+    {
+        //accuracy of the approximations of the gaussian against the naive filter
+        for (float sigma : {2.f,5.f,10.f,20.f})
+        {
+            report_accuracy<pandora::gaussian_recursive_filter>("gaussian_recursive_filter",sigma);
+            report_accuracy<pandora::gaussian_box_filter<3>>("gaussian_box_filter<3>",sigma);
+            report_accuracy<pandora::gaussian_box_filter<4>>("gaussian_box_filter<4>",sigma);
+            report_accuracy<pandora::gaussian_box_filter<5>>("gaussian_box_filter<5>",sigma);
+        }
+        return 0;
+    }
+    
+    pandora::thread_pool pool;
+    std::vector<benchmark_case> benchmarks;
+    
+    const image_size sizes[] = {{"320x240",320,240},{"640x480",640,480},{"1280x720",1280,720},
+                                {"1920x1080",1920,1080},{"3840x2160",3840,2160},{"7680x4320",7680,4320}};
+    
+    //kernel sizes and frame sizes, the kernel covers +-3 sigma
+    for (const auto& size : sizes)
+    {
+        for (int kernel_size : {3,7,15,31})
+        {
+            const float sigma = kernel_size / 6.f;
+            
+            //the naive filter is the reference, it is only timed on the small configurations
+            if (size.width * size.height <= 1920 * 1080 && kernel_size <= 7)
+            {
+                add<naive_filter>(benchmarks,"gaussian_naive_filter",size,kernel_size,sigma);
+            }
+            add<pandora::gaussian_separable_filter>(benchmarks,"gaussian_separable_filter",size,kernel_size,sigma);
+            add<pandora::gaussian_simd_filter>(benchmarks,"gaussian_simd_filter",size,kernel_size,sigma);
+            if (pool.size() > 1)
+            {
+                add<pandora::gaussian_simd_filter>(benchmarks,"gaussian_simd_filter",size,kernel_size,sigma,&pool);
+            }
+            add<pandora::gaussian_recursive_filter>(benchmarks,"gaussian_recursive_filter",size,kernel_size,sigma);
+            add<pandora::gaussian_box_filter<3>>(benchmarks,"gaussian_box_filter<3>",size,kernel_size,sigma);
+            add<auto_filter>(benchmarks,"gaussian_auto_filter",size,kernel_size,sigma);
+        }
+    }
+    
+    //large sigma blurs : the cost of the recursive, box and fft filters does not depend on sigma
+    for (float sigma : {5.f,20.f,50.f})
+    {
+        const int kernel_size = 2*static_cast<int>(std::ceil(3*sigma))+1;
+        add<pandora::gaussian_simd_filter>(benchmarks,"gaussian_simd_filter",sizes[3],kernel_size,sigma);
+        add<pandora::gaussian_recursive_filter>(benchmarks,"gaussian_recursive_filter",sizes[3],kernel_size,sigma);
+        add<pandora::gaussian_box_filter<3>>(benchmarks,"gaussian_box_filter<3>",sizes[3],kernel_size,sigma);
+        add<pandora::gaussian_fft_filter>(benchmarks,"gaussian_fft_filter",sizes[3],kernel_size,sigma);
+    }
+    
+    //crossover of the separable and fft filters on large kernels
+    for (int kernel_size : {31,51,75,101,151,201})
+    {
+        const float sigma = kernel_size / 6.f;
+        add<pandora::gaussian_separable_filter>(benchmarks,"crossover/gaussian_separable_filter",sizes[3],kernel_size,sigma);
+        add<pandora::gaussian_simd_filter>(benchmarks,"crossover/gaussian_simd_filter",sizes[3],kernel_size,sigma);
+        add<pandora::gaussian_fft_filter>(benchmarks,"crossover/gaussian_fft_filter",sizes[3],kernel_size,sigma);
+    }
+    
+    //batches of thumbnails : one call per batch against one filter per thumbnail
+    const image_size thumbnail_sizes[] = {{"96x96",96,96},{"160x120",160,120}};
+    for (const auto& size : thumbnail_sizes)
+    {
+        add_unbatched<pandora::gaussian_simd_filter>(benchmarks,"gaussian_simd_filter",size,256,7,7/6.f);
+        add_batch<pandora::gaussian_simd_filter>(benchmarks,"gaussian_simd_filter",size,256,7,7/6.f);
+        if (pool.size() > 1)
+        {
+            add_batch<pandora::gaussian_simd_filter>(benchmarks,"gaussian_simd_filter",size,256,7,7/6.f,&pool);
+        }
+    }
+    
+    //5 level pyramids : fused blur and decimation against a blur and a resize per level
+    for (const auto& size : {sizes[1],sizes[3]})
+    {
+        add_blur_resize_pyramid(benchmarks,size,5,5,1.f);
+        add_pyramid(benchmarks,size,5,5,1.f);
+        if (pool.size() > 1)
+        {
+            add_pyramid(benchmarks,size,5,5,1.f,&pool);
+        }
+    }
+    
+    //5 level scale spaces of an octave : incremental blurs against a direct blur per level
+    for (const auto& size : {sizes[1],sizes[3]})
+    {
+        add_direct_scale_space(benchmarks,size,5,1.6f,std::sqrt(2.f));
+        add_scale_space(benchmarks,size,5,1.6f,std::sqrt(2.f));
+    }
+    
+    //unsharp mask : fused blur and sharpening against a blurred image and a sharpening pass
+    for (const auto& size : {sizes[1],sizes[3]})
+    {
+        add_blur_sharpen(benchmarks,size,7,1.5f,1.f,4.f);
+        add_unsharp_mask(benchmarks,size,7,1.5f,1.f,4.f);
+    }
+    
+    if (!wisdom_path.empty())
+    {
+        planner().load_wisdom(wisdom_path);
+    }
+    
+    std::vector<benchmark_result> results;
+    const double minimum_time = std::atof(minimum_time_text.c_str());
+    
+    if (!list_only)
+    {
+        std::printf("%-56s %12s %12s %12s %10s %10s %12s\n","benchmark","time (ms)","MP/s","images/s","cycles/px","GB/s","iterations");
+    }
+    for (const auto& benchmark : benchmarks)
+    {
+        if (benchmark.name.find(filter_text) == std::string::npos)
+        {
+            continue;
+        }
+        if (list_only)
+        {
+            std::printf("%s\n",benchmark.name.c_str());
+            continue;
+        }
+        
+        const benchmark_result result = run(benchmark,minimum_time);
+        std::printf("%-56s %12.3f %12.2f %12.1f %10.2f %10.2f %12d\n",result.name.c_str(),result.milliseconds,
+                    result.megapixels_per_second,result.images_per_second,result.cycles_per_pixel,
+                    result.gigabytes_per_second,result.iterations);
+        std::fflush(stdout);
+        results.push_back(result);
+    }
+    
+    if (!wisdom_path.empty() && !list_only && !planner().save_wisdom(wisdom_path))
+    {
+        std::fprintf(stderr,"cannot write %s\n",wisdom_path.c_str());
+        return 1;
+    }
+    
+    if (!output_path.empty() && !write_json(output_path.c_str(),results))
+    {
+        std::fprintf(stderr,"cannot write %s\n",output_path.c_str());
+        return 1;
+    }
+    
+    return 0;
+}
@@ -0,0 +1,116 @@
+/*BSD 3-Clause License
+
+Copyright (c) 2018, eelcoder
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+* Redistributions of source code must retain the above copyright notice, this
+list of conditions and the following disclaimer.
+
+* Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentation
+and/or other materials provided with the distribution.
+
+* Neither the name of the copyright holder nor the names of its
+contributors may be used to endorse or promote products derived from
+this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+         SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+#ifndef __PANDORA_CPU_FEATURES_H__
+#define __PANDORA_CPU_FEATURES_H__
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define PANDORA_X86 1
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#include <immintrin.h>
+#endif
+
+//enable an instruction set on a single function, MSVC does not need it to emit intrinsics
+#if defined(__GNUC__) || defined(__clang__)
+#define PANDORA_TARGET(instruction_set) __attribute__((target(instruction_set)))
+#else
+#define PANDORA_TARGET(instruction_set)
+#endif
+
+namespace pandora
+{
+    /**
+     * \brief instruction sets used by the vectorized code paths, ordered by capability.
+     */
+    enum class simd_level
+    {
+        scalar,
+        sse41,
+        avx2
+    };
+    
+    namespace details
+    {
+        /**
+         * \brief query the cpu (and the os support of the wide registers) for the available instruction sets.
+         *
+         * \return best instruction set supported by the running machine.
+         */
+        inline simd_level detect_simd_level()
+        {
+#if defined(PANDORA_X86) && (defined(__GNUC__) || defined(__clang__))
+            __builtin_cpu_init();
+            if (__builtin_cpu_supports("avx2"))
+            {
+                return simd_level::avx2;
+            }
+            if (__builtin_cpu_supports("sse4.1"))
+            {
+                return simd_level::sse41;
+            }
+#elif defined(PANDORA_X86) && defined(_MSC_VER)
+            int registers[4];
+            __cpuid(registers,0);
+            const int max_leaf = registers[0];
+            
+            __cpuid(registers,1);
+            const bool has_sse41 = (registers[2] & (1 << 19)) != 0;
+            const bool has_osxsave = (registers[2] & (1 << 27)) != 0;
+            
+            if (max_leaf >= 7 && has_osxsave && (_xgetbv(0) & 0x6) == 0x6)
+            {
+                __cpuidex(registers,7,0);
+                if ((registers[1] & (1 << 5)) != 0)
+                {
+                    return simd_level::avx2;
+                }
+            }
+            if (has_sse41)
+            {
+                return simd_level::sse41;
+            }
+#endif
+            return simd_level::scalar;
+        }
+    }
+    
+    /**
+     * \brief best instruction set supported by the running machine, detected once.
+     */
+    inline simd_level cpu_simd_level()
+    {
+        static const simd_level level = details::detect_simd_level();
+        return level;
+    }
+}
+
+#endif //__PANDORA_CPU_FEATURES_H__
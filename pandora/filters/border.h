@@ -0,0 +1,122 @@
+/*BSD 3-Clause License
+
+Copyright (c) 2018, eelcoder
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+* Redistributions of source code must retain the above copyright notice, this
+list of conditions and the following disclaimer.
+
+* Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentation
+and/or other materials provided with the distribution.
+
+* Neither the name of the copyright holder nor the names of its
+contributors may be used to endorse or promote products derived from
+this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+         SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+#ifndef __PANDORA_FILTER_BORDER_H__
+#define __PANDORA_FILTER_BORDER_H__
+
+#include <cstdint>
+
+namespace pandora
+{
+    namespace filter
+    {
+        /**
+         * Border policies : how a filter reads the pixels outside of the image.
+         * index(i,size) maps a coordinate to the coordinate of the pixel read, in [0,size), or to -1
+         * when the constant value of the policy is read instead. The value is a float, the filters convert it
+         * to their pixel type (details::border_value) : rounded and saturated to the range of the integer pixels.
+         *
+         * Only the kernel_radius pixels along the borders go through the policy, the interior of the
+         * image is read directly. The recursive and box filters always replicate the border (clamp).
+         */
+        
+        /**
+         * \brief replicate the border pixel : aaa|abcd|ddd.
+         */
+        struct border_clamp
+        {
+            static constexpr float value = 0.f;
+            
+            static int index(int i,int size)
+            {
+                return (i < 0) ? 0 : ((i >= size) ? size-1 : i);
+            }
+        };
+        
+        /**
+         * \brief mirror without repeating the border pixel : dcb|abcd|cba.
+         */
+        struct border_reflect101
+        {
+            static constexpr float value = 0.f;
+            
+            static int index(int i,int size)
+            {
+                if (size == 1)
+                {
+                    return 0;
+                }
+                
+                //the mirrored image has a period of 2 x (size - 1)
+                const int period = 2*(size-1);
+                i %= period;
+                if (i < 0)
+                {
+                    i += period;
+                }
+                return (i < size) ? i : period-i;
+            }
+        };
+        
+        /**
+         * \brief repeat the image : bcd|abcd|abc.
+         */
+        struct border_wrap
+        {
+            static constexpr float value = 0.f;
+            
+            static int index(int i,int size)
+            {
+                i %= size;
+                return (i < 0) ? i+size : i;
+            }
+        };
+        
+        /**
+         * \brief constant pixel outside of the image : vvv|abcd|vvv.
+         * \tparam pixel value : up to 65535 for the 16 bit pixels, negative for the floating point ones.
+         */
+        template<int constant = 0>
+        struct border_constant
+        {
+            static constexpr float value = static_cast<float>(constant);
+            
+            static int index(int i,int size)
+            {
+                return (i < 0 || i >= size) ? -1 : i;
+            }
+        };
+        
+        template<int constant>
+        constexpr float border_constant<constant>::value;
+    }
+}
+
+#endif //__PANDORA_FILTER_BORDER_H__
@@ -0,0 +1,263 @@
+/*BSD 3-Clause License
+
+Copyright (c) 2018, eelcoder
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+* Redistributions of source code must retain the above copyright notice, this
+list of conditions and the following disclaimer.
+
+* Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentation
+and/or other materials provided with the distribution.
+
+* Neither the name of the copyright holder nor the names of its
+contributors may be used to endorse or promote products derived from
+this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+         SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+#ifndef __PANDORA_FILTER_FFT_H__
+#define __PANDORA_FILTER_FFT_H__
+
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <vector>
+
+namespace pandora
+{
+    namespace filter
+    {
+        namespace details
+        {
+            /**
+             * \brief smallest power of two greater or equal to a size.
+             */
+            inline int fft_size(int size)
+            {
+                int power = 1;
+                while (power < size)
+                {
+                    power *= 2;
+                }
+                return power;
+            }
+            
+            /**
+             * \brief radix-2 complex FFT of a power of two size, in place and unnormalized.
+             *        The forward transform (decimation in frequency) takes values in natural order and
+             *        produces the spectrum in bit reversed order, the inverse transform (decimation in time)
+             *        takes the spectrum in bit reversed order and produces values in natural order :
+             *        a convolution multiplies the spectrum point by point and never pays for the permutation.
+             */
+            class fft
+            {
+                
+            public:
+                
+                using complex = std::complex<float>;
+                
+                /**
+                 * \brief constructor.
+                 *
+                 * \param[in] transform size, a power of two.
+                 */
+                explicit fft(int size = 1):
+                    transform_size(size),reversed(size),twiddles(std::max(size,2))
+                {
+                    int bits = 0;
+                    while ((1 << bits) < size)
+                    {
+                        ++bits;
+                    }
+                    for (int i = 0; i < size; ++i)
+                    {
+                        int reversed_index = 0;
+                        for (int bit = 0; bit < bits; ++bit)
+                        {
+                            reversed_index |= ((i >> bit) & 1) << (bits-1-bit);
+                        }
+                        reversed[i] = reversed_index;
+                    }
+                    
+                    //the twiddles of the pass combining blocks of 2 x half values are contiguous, at [half,2 x half)
+                    //computed in double, the rounding of the twiddles drives the accuracy of the transform
+                    const double pi = std::acos(-1.0);
+                    for (int half = 1; half < size; half *= 2)
+                    {
+                        for (int j = 0; j < half; ++j)
+                        {
+                            const double angle = -pi*j/half;
+                            twiddles[half+j] = complex(static_cast<float>(std::cos(angle)),static_cast<float>(std::sin(angle)));
+                        }
+                    }
+                }
+                
+                /**
+                 * \brief transform size.
+                 */
+                int size() const
+                {
+                    return transform_size;
+                }
+                
+                /**
+                 * \brief frequency held at a position of the bit reversed spectrum.
+                 *
+                 * \param[in] position in the spectrum.
+                 * \return frequency.
+                 */
+                int frequency(int i) const
+                {
+                    return reversed[i];
+                }
+                
+                /**
+                 * \brief forward transform of contiguous values.
+                 *
+                 * \param[in,out] size values in natural order, replaced by their spectrum in bit reversed order.
+                 */
+                void forward(complex* data) const
+                {
+                    for (int length = transform_size; length >= 2; length /= 2)
+                    {
+                        const int half = length/2;
+                        const float* stage_twiddles = reinterpret_cast<const float*>(twiddles.data()+half);
+                        for (int i = 0; i < transform_size; i += length)
+                        {
+                            float* even = reinterpret_cast<float*>(data+i);
+                            float* odd = reinterpret_cast<float*>(data+i+half);
+                            for (int j = 0; j < 2*half; j += 2)
+                            {
+                                const float difference_real = even[j] - odd[j];
+                                const float difference_imag = even[j+1] - odd[j+1];
+                                even[j] += odd[j];
+                                even[j+1] += odd[j+1];
+                                odd[j] = difference_real*stage_twiddles[j] - difference_imag*stage_twiddles[j+1];
+                                odd[j+1] = difference_real*stage_twiddles[j+1] + difference_imag*stage_twiddles[j];
+                            }
+                        }
+                    }
+                }
+                
+                /**
+                 * \brief inverse transform of contiguous values, without the 1/size scaling.
+                 *
+                 * \param[in,out] spectrum in bit reversed order, replaced by the values in natural order.
+                 */
+                void inverse(complex* data) const
+                {
+                    for (int length = 2; length <= transform_size; length *= 2)
+                    {
+                        const int half = length/2;
+                        const float* stage_twiddles = reinterpret_cast<const float*>(twiddles.data()+half);
+                        for (int i = 0; i < transform_size; i += length)
+                        {
+                            float* even = reinterpret_cast<float*>(data+i);
+                            float* odd = reinterpret_cast<float*>(data+i+half);
+                            for (int j = 0; j < 2*half; j += 2)
+                            {
+                                //conjugated twiddle
+                                const float odd_real = odd[j]*stage_twiddles[j] + odd[j+1]*stage_twiddles[j+1];
+                                const float odd_imag = odd[j+1]*stage_twiddles[j] - odd[j]*stage_twiddles[j+1];
+                                odd[j] = even[j] - odd_real;
+                                odd[j+1] = even[j+1] - odd_imag;
+                                even[j] += odd_real;
+                                even[j+1] += odd_imag;
+                            }
+                        }
+                    }
+                }
+                
+                /**
+                 * \brief forward transform of each column of a row major array of size rows.
+                 *        The butterflies combine whole rows, so the memory is walked row by row.
+                 *
+                 * \param[in,out] size rows of width values.
+                 * \param[in] number of columns to transform.
+                 * \param[in] distance between two rows.
+                 */
+                void forward_columns(complex* data,int width,int stride) const
+                {
+                    for (int length = transform_size; length >= 2; length /= 2)
+                    {
+                        const int half = length/2;
+                        for (int i = 0; i < transform_size; i += length)
+                        {
+                            for (int j = 0; j < half; ++j)
+                            {
+                                const float twiddle_real = twiddles[half+j].real();
+                                const float twiddle_imag = twiddles[half+j].imag();
+                                float* even_row = reinterpret_cast<float*>(data+(i+j)*stride);
+                                float* odd_row = reinterpret_cast<float*>(data+(i+j+half)*stride);
+                                for (int x = 0; x < 2*width; x += 2)
+                                {
+                                    const float difference_real = even_row[x] - odd_row[x];
+                                    const float difference_imag = even_row[x+1] - odd_row[x+1];
+                                    even_row[x] += odd_row[x];
+                                    even_row[x+1] += odd_row[x+1];
+                                    odd_row[x] = difference_real*twiddle_real - difference_imag*twiddle_imag;
+                                    odd_row[x+1] = difference_real*twiddle_imag + difference_imag*twiddle_real;
+                                }
+                            }
+                        }
+                    }
+                }
+                
+                /**
+                 * \brief inverse transform of each column of a row major array of size rows, without the 1/size scaling.
+                 *
+                 * \param[in,out] size rows of width values.
+                 * \param[in] number of columns to transform.
+                 * \param[in] distance between two rows.
+                 */
+                void inverse_columns(complex* data,int width,int stride) const
+                {
+                    for (int length = 2; length <= transform_size; length *= 2)
+                    {
+                        const int half = length/2;
+                        for (int i = 0; i < transform_size; i += length)
+                        {
+                            for (int j = 0; j < half; ++j)
+                            {
+                                const float twiddle_real = twiddles[half+j].real();
+                                const float twiddle_imag = -twiddles[half+j].imag();
+                                float* even_row = reinterpret_cast<float*>(data+(i+j)*stride);
+                                float* odd_row = reinterpret_cast<float*>(data+(i+j+half)*stride);
+                                for (int x = 0; x < 2*width; x += 2)
+                                {
+                                    const float odd_real = odd_row[x]*twiddle_real - odd_row[x+1]*twiddle_imag;
+                                    const float odd_imag = odd_row[x]*twiddle_imag + odd_row[x+1]*twiddle_real;
+                                    odd_row[x] = even_row[x] - odd_real;
+                                    odd_row[x+1] = even_row[x+1] - odd_imag;
+                                    even_row[x] += odd_real;
+                                    even_row[x+1] += odd_imag;
+                                }
+                            }
+                        }
+                    }
+                }
+                
+            private:
+                
+                int transform_size;
+                std::vector<int> reversed;
+                std::vector<complex> twiddles;
+            };
+        }
+    }
+}
+
+#endif //__PANDORA_FILTER_FFT_H__
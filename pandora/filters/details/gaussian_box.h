@@ -0,0 +1,302 @@
+/*BSD 3-Clause License
+
+Copyright (c) 2018, eelcoder
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+* Redistributions of source code must retain the above copyright notice, this
+list of conditions and the following disclaimer.
+
+* Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentation
+and/or other materials provided with the distribution.
+
+* Neither the name of the copyright holder nor the names of its
+contributors may be used to endorse or promote products derived from
+this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+         SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+#ifndef __PANDORA_FILTER_GAUSSIAN_BOX_H__
+#define __PANDORA_FILTER_GAUSSIAN_BOX_H__
+
+#include <pandora/image.h>
+#include <pandora/filters/details/pixel_traits.h>
+#include <algorithm>
+#include <cmath>
+#include <utility>
+#include <vector>
+
+namespace pandora
+{
+    namespace filter
+    {
+        namespace details
+        {
+            /**
+             * \brief Apply an approximation of the Gaussian filter on a grayscale image.
+             *        Iterated box filters (central limit theorem), computed with running sums.
+             *
+             *        The widths of the boxes follow Kovesi (2010) : pass_count boxes of two consecutive odd
+             *        widths whose variances sum to sigma2. Each pass costs O(1) per pixel whatever sigma,
+             *        the kernel size is ignored and the border pixels are replicated.
+             *
+             *        Accuracy against gaussian_naive_impl with a kernel covering +-3 sigma, on uniform noise
+             *        (320x240, maximum / mean absolute difference in grey levels) :
+             *
+             *              |  sigma 2   |  sigma 5   |  sigma 10  |  sigma 20
+             *        3 box |  4 / 0.79  |  1 / 0.16  |  1 / 0.10  |  1 / 0.08
+             *        4 box |  4 / 0.74  |  1 / 0.11  |  2 / 0.12  |  1 / 0.06
+             *        5 box |  4 / 0.79  |  2 / 0.18  |  1 / 0.06  |  1 / 0.05
+             *
+             *        The box widths are odd integers, so more passes do not always mean a closer variance :
+             *        pandora_benchmarks prints this report for the current code.
+             *
+             *        The running sums are floats whatever the pixel type.
+             *
+             * \tparam number of box filters per axis, from 3 to 5.
+             * \tparam pixel type : uint8_t, uint16_t or float.
+             * \remark for more info, see https://eelcoder.wordpress.com.
+             */
+            template<int pass_count,typename pixel_type = uint8_t>
+            class gaussian_box_impl
+            {
+                static_assert(pass_count >= 3 && pass_count <= 5, "the gaussian approximation needs 3 to 5 box filters");
+                
+            public:
+                
+                using image_type = pandora::image<pixel_type>;
+                
+                /**
+                 * \brief constructor.
+                 *
+                 * \param[in] image width.
+                 * \param[in] image height.
+                 * \param[in] kernel size, unused.
+                 * \param[in] gaussian sigma.
+                 */
+                inline gaussian_box_impl(int image_width,int image_height,int /*kernel_size*/,float sigma)
+                {
+                    //ideal box width, rounded to the nearest odd widths below and above
+                    const double variance = 12.0 * sigma * sigma;
+                    const double ideal_width = std::sqrt(variance / pass_count + 1.0);
+                    int lower_width = static_cast<int>(std::floor(ideal_width));
+                    if (lower_width % 2 == 0)
+                    {
+                        --lower_width;
+                    }
+                    const int upper_width = lower_width + 2;
+                    
+                    //number of lower boxes so that the total variance is the closest to sigma2
+                    const double lower_count = (variance - pass_count * lower_width * lower_width - 4.0 * pass_count * lower_width - 3.0 * pass_count)
+                                               / (-4.0 * lower_width - 4.0);
+                    const int lower_passes = std::max(0,std::min(pass_count,static_cast<int>(std::lround(lower_count))));
+                    
+                    total_radius = 0;
+                    for (int pass = 0; pass < pass_count; ++pass)
+                    {
+                        radii[pass] = ((pass < lower_passes) ? lower_width : upper_width) / 2;
+                        total_radius += radii[pass];
+                    }
+                    
+                    reserve(image_width,image_height);
+                }
+                
+                /**
+                 * \brief apply a gaussian filter on all the channels of an image.
+                 *
+                 * \param[in] input image.
+                 * \param[out] output image.
+                 */
+                void apply(const image_type &input_image, image_type &output_image)
+                {
+                    reserve(input_image.width(),input_image.height());
+                    
+                    for (int c = 0; c < input_image.spectrum(); ++c)
+                    {
+                        apply_channel(input_image,output_image,c);
+                    }
+                }
+                
+            private:
+                
+                /**
+                 * \brief apply a gaussian filter on a channel of an image.
+                 *
+                 * \param[in] input image.
+                 * \param[out] output image.
+                 * \param[in] channel.
+                 */
+                void apply_channel(const image_type &input_image, image_type &output_image,int c)
+                {
+                    const int width = input_image.width();
+                    const int height = input_image.height();
+                    
+                    //apply the horizontal box filters, row by row
+                    for (auto y = 0; y < height; ++y)
+                    {
+                        const pixel_type* input_row = input_image.data(0,y,0,c);
+                        std::fill(first_row.begin(),first_row.begin()+total_radius,input_row[0]);
+                        std::copy(input_row,input_row+width,first_row.begin()+total_radius);
+                        std::fill(first_row.begin()+total_radius+width,first_row.begin()+2*total_radius+width,input_row[width-1]);
+                        
+                        float* current = first_row.data();
+                        float* other = second_row.data();
+                        int length = width + 2*total_radius;
+                        
+                        for (int pass = 0; pass < pass_count; ++pass)
+                        {
+                            box_row(current,other,length,radii[pass]);
+                            length -= 2*radii[pass];
+                            std::swap(current,other);
+                        }
+                        
+                        std::copy(current,current+width,source_image.data(0,y+total_radius));
+                    }
+                    
+                    //replicate the top and bottom rows
+                    for (int y = 0; y < total_radius; ++y)
+                    {
+                        std::copy(source_image.data(0,total_radius),source_image.data(0,total_radius)+width,source_image.data(0,y));
+                        std::copy(source_image.data(0,total_radius+height-1),source_image.data(0,total_radius+height-1)+width,
+                                  source_image.data(0,total_radius+height+y));
+                    }
+                    
+                    //apply the vertical box filters on whole rows so that the memory is read linearly
+                    int length = height + 2*total_radius;
+                    for (int pass = 0; pass < pass_count; ++pass)
+                    {
+                        box_columns(source_image,target_image,width,length,radii[pass]);
+                        length -= 2*radii[pass];
+                        std::swap(source_image,target_image);
+                    }
+                    
+                    for (auto y = 0; y < height; ++y)
+                    {
+                        const float* filtered_row = source_image.data(0,y);
+                        pixel_type* output_row = output_image.data(0,y,0,c);
+                        
+                        for (int x = 0; x < width; ++x)
+                        {
+                            output_row[x] = pixel_traits<pixel_type>::from_float(filtered_row[x]);
+                        }
+                    }
+                }
+                
+                /**
+                 * \brief grow the buffers to hold an image, they are kept for the next images.
+                 *        The borders are replicated once, by the radius of the whole filter, then each pass
+                 *        only keeps the samples covered by its full box.
+                 *
+                 * \param[in] image width.
+                 * \param[in] image height.
+                 */
+                void reserve(int width,int height)
+                {
+                    if (static_cast<int>(sums.size()) < width)
+                    {
+                        first_row.resize(width+2*total_radius);
+                        second_row.resize(width+2*total_radius);
+                        sums.resize(width);
+                    }
+                    if (source_image.width() < width || source_image.height() < height+2*total_radius)
+                    {
+                        const int buffer_width = std::max(width,source_image.width());
+                        const int buffer_height = std::max(height+2*total_radius,source_image.height());
+                        source_image.assign(buffer_width,buffer_height,1,1,0.f);
+                        target_image.assign(buffer_width,buffer_height,1,1,0.f);
+                    }
+                }
+                
+                /**
+                 * \brief box filter on a row, with a running sum.
+                 *        Only the length - 2 x radius samples covered by the full box are written.
+                 *
+                 * \param[in] input row.
+                 * \param[out] output row.
+                 * \param[in] input row length.
+                 * \param[in] box radius.
+                 */
+                static void box_row(const float* input_row,float* output_row,int length,int radius)
+                {
+                    const int box_width = 2 * radius + 1;
+                    const float normalization = 1.f / box_width;
+                    
+                    float sum = 0;
+                    for (int x = 0; x < box_width - 1; ++x)
+                    {
+                        sum += input_row[x];
+                    }
+                    
+                    for (int x = 0; x + box_width <= length; ++x)
+                    {
+                        sum += input_row[x+box_width-1];
+                        output_row[x] = sum * normalization;
+                        sum -= input_row[x];
+                    }
+                }
+                
+                /**
+                 * \brief box filter on the columns of an image, with a row of running sums.
+                 *        Only the length - 2 x radius rows covered by the full box are written.
+                 *
+                 * \param[in] input image.
+                 * \param[out] output image.
+                 * \param[in] image width.
+                 * \param[in] number of input rows.
+                 * \param[in] box radius.
+                 */
+                void box_columns(const pandora::image<float> &input,pandora::image<float> &output,int width,int length,int radius)
+                {
+                    const int box_width = 2 * radius + 1;
+                    const float normalization = 1.f / box_width;
+                    
+                    std::fill(sums.begin(),sums.end(),0.f);
+                    for (int y = 0; y < box_width - 1; ++y)
+                    {
+                        const float* input_row = input.data(0,y);
+                        for (int x = 0; x < width; ++x)
+                        {
+                            sums[x] += input_row[x];
+                        }
+                    }
+                    
+                    for (auto y = 0; y + box_width <= length; ++y)
+                    {
+                        const float* entering_row = input.data(0,y+box_width-1);
+                        const float* leaving_row = input.data(0,y);
+                        float* output_row = output.data(0,y);
+                        
+                        for (int x = 0; x < width; ++x)
+                        {
+                            sums[x] += entering_row[x];
+                            output_row[x] = sums[x] * normalization;
+                            sums[x] -= leaving_row[x];
+                        }
+                    }
+                }
+                
+                int radii[pass_count];
+                int total_radius;
+                std::vector<float> first_row;
+                std::vector<float> second_row;
+                std::vector<float> sums;
+                pandora::image<float> source_image;
+                pandora::image<float> target_image;
+            };
+        }
+    }
+}
+
+#endif //__PANDORA_FILTER_GAUSSIAN_BOX_H__
@@ -0,0 +1,360 @@
+/*BSD 3-Clause License
+
+Copyright (c) 2018, eelcoder
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+* Redistributions of source code must retain the above copyright notice, this
+list of conditions and the following disclaimer.
+
+* Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentation
+and/or other materials provided with the distribution.
+
+* Neither the name of the copyright holder nor the names of its
+contributors may be used to endorse or promote products derived from
+this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+         SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+#ifndef __PANDORA_FILTER_GAUSSIAN_DECIMATION_H__
+#define __PANDORA_FILTER_GAUSSIAN_DECIMATION_H__
+
+#include <pandora/image.h>
+#include <pandora/cpu_features.h>
+#include <pandora/filters/border.h>
+#include <pandora/filters/details/gaussian_kernel.h>
+#include <pandora/filters/details/gaussian_separable.h>
+#include <pandora/filters/details/separable_convolution.h>
+#include <algorithm>
+#include <type_traits>
+#include <vector>
+
+namespace pandora
+{
+    namespace filter
+    {
+        namespace details
+        {
+#if defined(PANDORA_X86)
+            /**
+             * \brief split 32 pixels per iteration.
+             *
+             * \return number of even pixels written.
+             */
+            PANDORA_TARGET("sse4.1")
+            inline int split_even_odd_sse41(const uint8_t* row,int width,uint8_t* even_row,uint8_t* odd_row)
+            {
+                const __m128i even_first = _mm_setr_epi8(0,2,4,6,8,10,12,14,1,3,5,7,9,11,13,15);
+                
+                int x = 0;
+                for (; 2*x + 32 <= width; x += 16)
+                {
+                    const __m128i low = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(row+2*x)),even_first);
+                    const __m128i high = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(row+2*x+16)),even_first);
+                    
+                    _mm_storeu_si128(reinterpret_cast<__m128i*>(even_row+x),_mm_unpacklo_epi64(low,high));
+                    _mm_storeu_si128(reinterpret_cast<__m128i*>(odd_row+x),_mm_unpackhi_epi64(low,high));
+                }
+                return x;
+            }
+#endif
+            
+#if defined(PANDORA_X86)
+            PANDORA_TARGET("sse4.1")
+            inline int accumulate_row_sse41(const uint16_t* row,int width,uint16_t* sum_row)
+            {
+                int x = 0;
+                for (; x + 8 <= width; x += 8)
+                {
+                    const __m128i values = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row+x));
+                    const __m128i sums = _mm_loadu_si128(reinterpret_cast<const __m128i*>(sum_row+x));
+                    _mm_storeu_si128(reinterpret_cast<__m128i*>(sum_row+x),_mm_add_epi16(sums,values));
+                }
+                return x;
+            }
+            
+            PANDORA_TARGET("sse4.1")
+            inline int accumulate_row_sse41(const float* row,int width,float* sum_row)
+            {
+                int x = 0;
+                for (; x + 4 <= width; x += 4)
+                {
+                    _mm_storeu_ps(sum_row+x,_mm_add_ps(_mm_loadu_ps(sum_row+x),_mm_loadu_ps(row+x)));
+                }
+                return x;
+            }
+#endif
+            
+            /**
+             * \brief add a row of horizontally filtered values to another one.
+             *
+             * \param[in] instruction set.
+             * \param[in] row to add.
+             * \param[in] row width.
+             * \param[in,out] sums.
+             */
+            template<typename value_type>
+            inline void accumulate_row(pandora::simd_level level,const value_type* row,int width,value_type* sum_row)
+            {
+                int x = 0;
+#if defined(PANDORA_X86)
+                if (level >= pandora::simd_level::sse41)
+                {
+                    x = accumulate_row_sse41(row,width,sum_row);
+                }
+#endif
+                for (; x < width; ++x)
+                {
+                    sum_row[x] += row[x];
+                }
+            }
+            
+            /**
+             * \brief split a row in its even pixels, (width+1)/2 of them, and its odd pixels, width/2 of them.
+             *
+             * \param[in] instruction set.
+             * \param[in] row.
+             * \param[in] row width.
+             * \param[out] even pixels.
+             * \param[out] odd pixels.
+             * \param[in] first even pixel to write, the previous ones are done.
+             */
+            template<typename pixel_type>
+            inline void split_even_odd(pandora::simd_level /*level*/,const pixel_type* row,int width,pixel_type* even_row,pixel_type* odd_row,
+                                       int x_begin = 0)
+            {
+                int x = x_begin;
+                for (; 2*x + 1 < width; ++x)
+                {
+                    even_row[x] = row[2*x];
+                    odd_row[x] = row[2*x+1];
+                }
+                if (width % 2 != 0)
+                {
+                    even_row[x] = row[width-1];
+                }
+            }
+            
+            inline void split_even_odd(pandora::simd_level level,const uint8_t* row,int width,uint8_t* even_row,uint8_t* odd_row)
+            {
+                int x = 0;
+#if defined(PANDORA_X86)
+                if (level >= pandora::simd_level::sse41)
+                {
+                    x = split_even_odd_sse41(row,width,even_row,odd_row);
+                }
+#endif
+                split_even_odd<uint8_t>(level,row,width,even_row,odd_row,x);
+            }
+            
+            /**
+             * \brief Gaussian filter followed by a 2x decimation, fused : only the even columns of the even rows
+             *        are filtered, the output is (width+1)/2 x (height+1)/2.
+             *
+             *        The horizontal pass splits the padded row in its even and odd pixels : the even columns of
+             *        the row are then the sum of the convolution of the even pixels by the even taps and of the
+             *        odd pixels by the odd taps, two contiguous convolutions of half width. The ring buffer keeps
+             *        the decimated rows of every input row, the vertical pass only runs on the even rows.
+             *        The arithmetic is the one of gaussian_separable_impl : for 8 bit pixels the sums are exact
+             *        integers, the output is bit exact with the even pixels of the filtered image.
+             *
+             * \tparam pixel type : uint8_t, uint16_t or float.
+             * \tparam border policy.
+             */
+            template<typename pixel_type = uint8_t,typename border = border_clamp>
+            class gaussian_decimation_impl
+            {
+                using arithmetic = separable_arithmetic<pixel_type>;
+                using intermediate_type = typename arithmetic::intermediate_type;
+                
+            public:
+                
+                /**
+                 * \brief constructor.
+                 *
+                 * \param[in] kernel size.
+                 * \param[in] gaussian sigma.
+                 * \param[in] instruction set to use, limited to the ones supported by the cpu.
+                 */
+                gaussian_decimation_impl(int kernel_size,float sigma,pandora::simd_level requested_level = pandora::cpu_simd_level()):
+                    kernel(kernel_size,sigma),
+                    level(std::min(requested_level,pandora::cpu_simd_level())),
+                    window(kernel.size()),
+                    even_pass(arithmetic::horizontal()),
+                    odd_pass(arithmetic::horizontal()),
+                    vertical_pass(arithmetic::vertical())
+                {
+                    const intermediate_type* weights = arithmetic::weights(kernel);
+                    for (int k = 0; k < kernel.size(); ++k)
+                    {
+                        (k % 2 == 0 ? even_weights : odd_weights).push_back(weights[k]);
+                    }
+                    use_fixed_convolutions(std::is_same<pixel_type,uint8_t>());
+                }
+                
+                /**
+                 * \brief filter and decimate a band of output rows of an image plane.
+                 *
+                 * \param[in] input plane.
+                 * \param[in] input width.
+                 * \param[in] input height.
+                 * \param[out] output plane, (width+1)/2 x (height+1)/2.
+                 * \param[in] first output row of the band.
+                 * \param[in] output row following the band.
+                 */
+                void apply(const pixel_type* input,int width,int height,pixel_type* output,int y_begin,int y_end)
+                {
+                    const int kernel_radius = kernel.radius();
+                    const int output_width = (width+1)/2;
+                    reserve(width);
+                    
+                    //input rows 2 y - kernel_radius to 2 y + kernel_radius make the output row y
+                    int previous_source = -1;
+                    int next_row = 2*y_begin-kernel_radius;
+                    for (int y = y_begin; y < y_end; ++y)
+                    {
+                        for (; next_row <= 2*y+kernel_radius; ++next_row)
+                        {
+                            filter_virtual_row(input,width,height,next_row,previous_source);
+                        }
+                        
+                        for (int k = -kernel_radius; k <= kernel_radius; ++k)
+                        {
+                            window[k+kernel_radius] = ring_row(2*y+k);
+                        }
+                        vertical_pass(level,window.data(),output_width,arithmetic::weights(kernel),kernel.size(),
+                                      output+static_cast<std::size_t>(y)*output_width);
+                    }
+                }
+                
+            private:
+                
+                /**
+                 * \brief use the row convolutions specialized for the usual kernel sizes, 8 bit pixels only.
+                 *        The even and the odd taps of a gaussian kernel are symmetric kernels as well.
+                 */
+                void use_fixed_convolutions(std::true_type)
+                {
+                    if (auto fixed_pass = fixed_horizontal_convolution(static_cast<int>(even_weights.size())))
+                    {
+                        even_pass = fixed_pass;
+                    }
+                    if (auto fixed_pass = fixed_horizontal_convolution(static_cast<int>(odd_weights.size())))
+                    {
+                        odd_pass = fixed_pass;
+                    }
+                    if (auto fixed_pass = fixed_vertical_convolution(kernel.size()))
+                    {
+                        vertical_pass = fixed_pass;
+                    }
+                }
+                
+                void use_fixed_convolutions(std::false_type)
+                {
+                }
+                
+                /**
+                 * \brief apply the horizontal pass on the even columns of a virtual row, read through the border policy.
+                 *
+                 * \param[in] input plane.
+                 * \param[in] input width.
+                 * \param[in] input height.
+                 * \param[in] virtual row index.
+                 * \param[in,out] input row of the previous virtual row, -1 if none.
+                 */
+                void filter_virtual_row(const pixel_type* input,int width,int height,int y,int &previous_source)
+                {
+                    const int kernel_radius = kernel.radius();
+                    const int output_width = (width+1)/2;
+                    const int source = border::index(y,height);
+                    intermediate_type* row = ring_row(y);
+                    
+                    if (source < 0)
+                    {
+                        std::fill(row,row+output_width,arithmetic::filtered_value(border_value<pixel_type,border>()));
+                    }
+                    else if (source == previous_source)
+                    {
+                        std::copy(ring_row(y-1),ring_row(y-1)+output_width,row);
+                    }
+                    else
+                    {
+                        pad_row<border>(input+static_cast<std::size_t>(source)*width,width,0,width,kernel_radius,padded_row.data());
+                        
+                        split_even_odd(level,padded_row.data(),width+2*kernel_radius,even_pixels.data(),odd_pixels.data());
+                        
+                        even_pass(level,even_pixels.data(),output_width,even_weights.data(),static_cast<int>(even_weights.size()),1,row);
+                        if (!odd_weights.empty())
+                        {
+                            odd_pass(level,odd_pixels.data(),output_width,odd_weights.data(),static_cast<int>(odd_weights.size()),1,odd_row.data());
+                            accumulate_row(level,odd_row.data(),output_width,row);
+                        }
+                    }
+                    previous_source = source;
+                }
+                
+                /**
+                 * \brief make room for input rows of width pixels, the buffers only grow.
+                 *
+                 * \param[in] input width.
+                 */
+                void reserve(int width)
+                {
+                    const int kernel_radius = kernel.radius();
+                    const int output_width = (width+1)/2;
+                    const std::size_t padded_size = static_cast<std::size_t>(width+2*kernel_radius);
+                    if (padded_row.size() < padded_size)
+                    {
+                        padded_row.resize(padded_size);
+                        even_pixels.resize((padded_size+1)/2);
+                        odd_pixels.resize(padded_size/2);
+                    }
+                    if (ring_image.width() < output_width)
+                    {
+                        ring_image.assign(output_width,kernel.size(),1,1,0);
+                        odd_row.resize(output_width);
+                    }
+                }
+                
+                /**
+                 * \brief row of the ring buffer holding a decimated virtual row.
+                 *
+                 * \param[in] virtual row index, from -kernel_size.
+                 * \return row of the ring buffer.
+                 */
+                intermediate_type* ring_row(int y)
+                {
+                    return ring_image.data(0,(y + kernel.size()) % kernel.size());
+                }
+                
+                gaussian_kernel kernel;
+                pandora::simd_level level;
+                std::vector<intermediate_type> even_weights;
+                std::vector<intermediate_type> odd_weights;
+                std::vector<pixel_type> padded_row;
+                std::vector<pixel_type> even_pixels;
+                std::vector<pixel_type> odd_pixels;
+                std::vector<intermediate_type> odd_row;
+                pandora::image<intermediate_type> ring_image;
+                std::vector<const intermediate_type*> window;
+                typename arithmetic::horizontal_pass even_pass;
+                typename arithmetic::horizontal_pass odd_pass;
+                typename arithmetic::vertical_pass vertical_pass;
+            };
+        }
+    }
+}
+
+#endif //__PANDORA_FILTER_GAUSSIAN_DECIMATION_H__
@@ -0,0 +1,151 @@
+/*BSD 3-Clause License
+
+Copyright (c) 2018, eelcoder
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+* Redistributions of source code must retain the above copyright notice, this
+list of conditions and the following disclaimer.
+
+* Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentation
+and/or other materials provided with the distribution.
+
+* Neither the name of the copyright holder nor the names of its
+contributors may be used to endorse or promote products derived from
+this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+         SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+#ifndef __PANDORA_FILTER_GAUSSIAN_DERIVATIVE_KERNEL_H__
+#define __PANDORA_FILTER_GAUSSIAN_DERIVATIVE_KERNEL_H__
+
+#include <cmath>
+#include <vector>
+
+namespace pandora
+{
+    namespace filter
+    {
+        namespace details
+        {
+            /**
+             * \brief 1D discrete kernel of a Gaussian derivative, applied as a correlation (sum of w[k] x in[x+k]).
+             *        order 0 : G(x,sigma), the weights sum to 1 (same weights as gaussian_kernel).
+             *        order 1 : x G(x,sigma), the weights sum to 0 and the response to the ramp in[x] = x is 1.
+             *        order 2 : (x2 - sigma2) G(x,sigma), the weights sum to 0 and the response to in[x] = x2 / 2 is 1.
+             */
+            class gaussian_derivative_kernel
+            {
+                
+            public:
+                
+                /**
+                 * \brief constructor.
+                 *
+                 * \param[in] kernel diameter.
+                 * \param[in] gaussian sigma.
+                 * \param[in] derivative order : 0, 1 or 2.
+                 */
+                inline gaussian_derivative_kernel(int kernel_size,float sigma,int order):
+                    kernel_radius(kernel_size/2),weights(2*(kernel_size/2)+1)
+                {
+                    const double sigma_squared = static_cast<double>(sigma)*sigma;
+                    
+                    double sum_weight = 0;
+                    std::vector<double> gaussian_weights(weights.size());
+                    for (int x = -kernel_radius; x <= kernel_radius; ++x)
+                    {
+                        gaussian_weights[x+kernel_radius] = std::exp(-((x * x) / (2.0 * sigma_squared)));
+                        sum_weight += gaussian_weights[x+kernel_radius];
+                    }
+                    
+                    std::vector<double> raw_weights(weights.size());
+                    for (int x = -kernel_radius; x <= kernel_radius; ++x)
+                    {
+                        const double g = gaussian_weights[x+kernel_radius];
+                        raw_weights[x+kernel_radius] = order == 0 ? g : (order == 1 ? x*g : (x*x - sigma_squared)*g);
+                    }
+                    
+                    if (order == 2)
+                    {
+                        //the sampled second derivative does not sum to 0 : remove its mean, weighted by the gaussian
+                        double sum_raw = 0;
+                        for (double w : raw_weights)
+                        {
+                            sum_raw += w;
+                        }
+                        for (std::size_t i = 0; i < raw_weights.size(); ++i)
+                        {
+                            raw_weights[i] -= gaussian_weights[i]*sum_raw/sum_weight;
+                        }
+                    }
+                    
+                    //normalize the response to x^order / order!
+                    double response = 0;
+                    for (int x = -kernel_radius; x <= kernel_radius; ++x)
+                    {
+                        response += raw_weights[x+kernel_radius]*(order == 0 ? 1.0 : (order == 1 ? x : x*x/2.0));
+                    }
+                    for (std::size_t i = 0; i < weights.size(); ++i)
+                    {
+                        weights[i] = response != 0 ? static_cast<float>(raw_weights[i] / response) : 0.f;
+                    }
+                }
+                
+                /**
+                 * \brief kernel radius, the kernel covers [-radius,radius].
+                 */
+                int radius() const
+                {
+                    return kernel_radius;
+                }
+                
+                /**
+                 * \brief number of taps of the kernel (2 x radius + 1).
+                 */
+                int size() const
+                {
+                    return static_cast<int>(weights.size());
+                }
+                
+                /**
+                 * \brief weight of a tap.
+                 *
+                 * \param[in] offset from the kernel center, in [-radius,radius].
+                 * \return weight.
+                 */
+                float operator[](int offset) const
+                {
+                    return weights[offset+kernel_radius];
+                }
+                
+                /**
+                 * \brief weights, from -radius to radius.
+                 */
+                const float* data() const
+                {
+                    return weights.data();
+                }
+                
+            private:
+                
+                int kernel_radius;
+                std::vector<float> weights;
+            };
+        }
+    }
+}
+
+#endif //__PANDORA_FILTER_GAUSSIAN_DERIVATIVE_KERNEL_H__
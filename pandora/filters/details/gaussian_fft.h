@@ -0,0 +1,279 @@
+/*BSD 3-Clause License
+
+Copyright (c) 2018, eelcoder
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+* Redistributions of source code must retain the above copyright notice, this
+list of conditions and the following disclaimer.
+
+* Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentation
+and/or other materials provided with the distribution.
+
+* Neither the name of the copyright holder nor the names of its
+contributors may be used to endorse or promote products derived from
+this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+         SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+#ifndef __PANDORA_FILTER_GAUSSIAN_FFT_H__
+#define __PANDORA_FILTER_GAUSSIAN_FFT_H__
+
+#include <pandora/image.h>
+#include <pandora/filters/border.h>
+#include <pandora/filters/details/fft.h>
+#include <pandora/filters/details/gaussian_kernel.h>
+#include <pandora/filters/details/pixel_traits.h>
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <vector>
+
+namespace pandora
+{
+    namespace filter
+    {
+        namespace details
+        {
+            /**
+             * \brief Apply a Gaussian filter on a grayscale image.
+             *        Implementation of the Gaussian filter in the frequency domain.
+             *
+             *        The image, padded by kernel_radius pixels through the border policy, is transformed
+             *        once, multiplied by the spectrum of the kernel and transformed back : the cost does
+             *        not depend on the kernel size, it pays off above kernel sizes of about 51.
+             *        The kernel is real, so the top and the bottom halves of the image are filtered
+             *        together as the real and imaginary parts of one complex image.
+             *        The spectrum of the separable kernel is the product of two 1D spectra, computed
+             *        once per (width, height, sigma).
+             *
+             *        The arithmetic is single precision floating point : the output is within 1 of the
+             *        naive filter.
+             *
+             * \tparam pixel type : uint8_t, uint16_t or float.
+             * \tparam border policy.
+             */
+            template<typename pixel_type = uint8_t,typename border = border_clamp>
+            class gaussian_fft_impl
+            {
+                
+            public:
+                
+                using image_type = pandora::image<pixel_type>;
+                
+                /**
+                 * \brief constructor.
+                 *
+                 * \param[in] image width.
+                 * \param[in] image height.
+                 * \param[in] kernel size.
+                 * \param[in] gaussian sigma.
+                 */
+                inline gaussian_fft_impl(int image_width,int image_height,int kernel_size,float sigma):
+                    kernel(kernel_size,sigma)
+                {
+                    plan(image_width,image_height);
+                }
+                
+                /**
+                 * \brief apply a gaussian filter on all the channels of an image.
+                 *
+                 * \param[in] input image.
+                 * \param[out] output image.
+                 */
+                void apply(const image_type &input_image, image_type &output_image)
+                {
+                    if (input_image.width() != image_width || input_image.height() != image_height)
+                    {
+                        plan(input_image.width(),input_image.height());
+                    }
+                    
+                    for (int c = 0; c < input_image.spectrum(); ++c)
+                    {
+                        apply_channel(input_image,output_image,c);
+                    }
+                }
+                
+            private:
+                
+                /**
+                 * \brief apply a gaussian filter on a channel of an image, the transforms are planned for its size.
+                 *
+                 * \param[in] input image.
+                 * \param[out] output image.
+                 * \param[in] channel.
+                 */
+                void apply_channel(const image_type &input_image, image_type &output_image,int c)
+                {
+                    const int width = input_image.width();
+                    const int height = input_image.height();
+                    const int kernel_radius = kernel.radius();
+                    
+                    //the top half is the real part, the bottom half the imaginary part
+                    const int half_height = (height+1)/2;
+                    const int padded_width = width+2*kernel_radius;
+                    const int padded_height = half_height+2*kernel_radius;
+                    const int stride = spectrum_stride();
+                    
+                    std::fill(spectrum.begin(),spectrum.end(),fft::complex(0.f,0.f));
+                    
+                    std::vector<int> columns(padded_width);
+                    for (int x = 0; x < padded_width; ++x)
+                    {
+                        columns[x] = border::index(x-kernel_radius,width);
+                    }
+                    
+                    for (int y = 0; y < padded_height; ++y)
+                    {
+                        const int top_row = border::index(y-kernel_radius,height);
+                        const int bottom_row = border::index(half_height+y-kernel_radius,height);
+                        fft::complex* row = spectrum.data()+y*stride;
+                        
+                        for (int x = 0; x < padded_width; ++x)
+                        {
+                            row[x] = fft::complex(pixel(input_image,columns[x],top_row,c),pixel(input_image,columns[x],bottom_row,c));
+                        }
+                        row_fft.forward(row);
+                    }
+                    
+                    //the column transforms, the product with the kernel spectrum and the inverse column transforms
+                    //run strip by strip, each strip stays in the cache for the log2(size) passes over it.
+                    //The transforms of narrow images are smaller than a strip : the last strip is cut to the transform
+                    for (int x = 0; x < row_fft.size(); x += strip_width)
+                    {
+                        const int strip_columns = std::min(strip_width,row_fft.size()-x);
+                        fft::complex* strip = spectrum.data()+x;
+                        column_fft.forward_columns(strip,strip_columns,stride);
+                        
+                        //the kernel spectrum is real and even : multiply both parts, in the bit reversed order of the transforms
+                        for (int v = 0; v < column_fft.size(); ++v)
+                        {
+                            fft::complex* row = strip+v*stride;
+                            for (int u = 0; u < strip_columns; ++u)
+                            {
+                                row[u] *= spectrum_x[x+u]*spectrum_y[v];
+                            }
+                        }
+                        
+                        column_fft.inverse_columns(strip,strip_columns,stride);
+                    }
+                    
+                    for (int y = 0; y < half_height; ++y)
+                    {
+                        fft::complex* row = spectrum.data()+(y+kernel_radius)*stride;
+                        row_fft.inverse(row);
+                        
+                        pixel_type* top_output = output_image.data(0,y,0,c);
+                        for (int x = 0; x < width; ++x)
+                        {
+                            top_output[x] = pixel_traits<pixel_type>::from_float(row[x+kernel_radius].real());
+                        }
+                        if (half_height+y < height)
+                        {
+                            pixel_type* bottom_output = output_image.data(0,half_height+y,0,c);
+                            for (int x = 0; x < width; ++x)
+                            {
+                                bottom_output[x] = pixel_traits<pixel_type>::from_float(row[x+kernel_radius].imag());
+                            }
+                        }
+                    }
+                }
+                
+                /**
+                 * \brief size the transforms for an image and compute the kernel spectrum.
+                 *        The transforms are at least as large as the padded image, so the circular
+                 *        convolution does not wrap around on the output pixels.
+                 *
+                 * \param[in] image width.
+                 * \param[in] image height.
+                 */
+                void plan(int width,int height)
+                {
+                    const int kernel_radius = kernel.radius();
+                    
+                    image_width = width;
+                    image_height = height;
+                    row_fft = fft(fft_size(width+2*kernel_radius));
+                    column_fft = fft(fft_size((height+1)/2+2*kernel_radius));
+                    spectrum.assign(static_cast<std::size_t>(spectrum_stride())*column_fft.size(),fft::complex(0.f,0.f));
+                    
+                    //the 1/size scaling of the inverse transforms is folded into the spectrum
+                    spectrum_x = kernel_spectrum(row_fft,1.0/row_fft.size());
+                    spectrum_y = kernel_spectrum(column_fft,1.0/column_fft.size());
+                }
+                
+                /**
+                 * \brief spectrum of the 1D kernel centered on 0 : g0 + 2 sum(gk x cos(2 pi u k / size)).
+                 *
+                 * \param[in] transform.
+                 * \param[in] scaling.
+                 * \return size real coefficients, in the bit reversed order of the transform.
+                 */
+                std::vector<float> kernel_spectrum(const fft &transform,double scale) const
+                {
+                    const double pi = std::acos(-1.0);
+                    const int size = transform.size();
+                    std::vector<float> coefficients(size);
+                    for (int i = 0; i < size; ++i)
+                    {
+                        const int u = transform.frequency(i);
+                        double sum = kernel[0];
+                        for (int k = 1; k <= kernel.radius(); ++k)
+                        {
+                            sum += 2.0*kernel[k]*std::cos(2.0*pi*u*k/size);
+                        }
+                        //the high frequencies of a gaussian vanish : flush them to 0 rather than computing on denormals
+                        coefficients[i] = (std::abs(sum) < 1e-9) ? 0.f : static_cast<float>(sum*scale);
+                    }
+                    return coefficients;
+                }
+                
+                /**
+                 * \brief distance between two rows of the spectrum. The rows are padded by a cache line :
+                 *        with a power of two distance, the rows of a strip would all map to the same cache sets.
+                 */
+                int spectrum_stride() const
+                {
+                    return row_fft.size() + 64/static_cast<int>(sizeof(fft::complex));
+                }
+                
+                /**
+                 * \brief pixel read through the border policy.
+                 */
+                static float pixel(const image_type &input_image,int x,int y,int c)
+                {
+                    return (x < 0 || y < 0) ? static_cast<float>(border_value<pixel_type,border>()) : input_image(x,y,0,c);
+                }
+                
+                //columns per strip of the column transforms, a multiple of the cache line
+                static constexpr int strip_width = 16;
+                
+                gaussian_kernel kernel;
+                int image_width = 0;
+                int image_height = 0;
+                fft row_fft;
+                fft column_fft;
+                std::vector<fft::complex> spectrum;
+                std::vector<float> spectrum_x;
+                std::vector<float> spectrum_y;
+            };
+            
+            template<typename pixel_type,typename border>
+            constexpr int gaussian_fft_impl<pixel_type,border>::strip_width;
+        }
+    }
+}
+
+#endif //__PANDORA_FILTER_GAUSSIAN_FFT_H__
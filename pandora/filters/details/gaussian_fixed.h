@@ -0,0 +1,102 @@
+/*BSD 3-Clause License
+
+Copyright (c) 2018, eelcoder
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+* Redistributions of source code must retain the above copyright notice, this
+list of conditions and the following disclaimer.
+
+* Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentation
+and/or other materials provided with the distribution.
+
+* Neither the name of the copyright holder nor the names of its
+contributors may be used to endorse or promote products derived from
+this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+         SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+#ifndef __PANDORA_FILTER_GAUSSIAN_FIXED_H__
+#define __PANDORA_FILTER_GAUSSIAN_FIXED_H__
+
+#include <pandora/image.h>
+#include <pandora/cpu_features.h>
+#include <pandora/filters/details/gaussian_separable.h>
+#include <pandora/filters/details/separable_convolution.h>
+#include <type_traits>
+
+namespace pandora
+{
+    namespace filter
+    {
+        namespace details
+        {
+            /**
+             * \brief Apply a Gaussian filter on a grayscale image.
+             *        Separable Gaussian filter specialized for a kernel size known at compile time.
+             *
+             *        The row convolutions have their taps unrolled, the symmetric taps folded (one
+             *        multiplication for two pixels) and their weights hoisted out of the pixel loop.
+             *        The output is identical to gaussian_separable_impl.
+             *        The specialized convolutions are the 8 bit ones, the other pixel types keep the generic ones.
+             *        A filter built with another kernel size runs the generic convolutions of that size.
+             *
+             * \tparam kernel size.
+             * \tparam pixel type : uint8_t, uint16_t or float.
+             * \tparam border policy.
+             */
+            template<int kernel_size,typename pixel_type = uint8_t,typename border = border_clamp>
+            class gaussian_fixed_impl : public gaussian_separable_impl<pixel_type,border>
+            {
+                static_assert(kernel_size >= 3 && kernel_size % 2 == 1, "the kernel size must be odd");
+                
+            public:
+                
+                /**
+                 * \brief constructor.
+                 *
+                 * \param[in] image width.
+                 * \param[in] image height.
+                 * \param[in] kernel size, the specialized convolutions run when it is the template parameter,
+                 *            the generic ones otherwise.
+                 * \param[in] gaussian sigma.
+                 * \param[in] instruction set to use, limited to the ones supported by the cpu.
+                 */
+                inline gaussian_fixed_impl(int image_width,int image_height,int requested_kernel_size,float sigma,
+                                           pandora::simd_level requested_level = pandora::cpu_simd_level()):
+                        gaussian_separable_impl<pixel_type,border>(image_width,image_height,requested_kernel_size,sigma,requested_level)
+                {
+                    if (requested_kernel_size == kernel_size)
+                    {
+                        use_fixed_convolutions(std::is_same<pixel_type,uint8_t>());
+                    }
+                }
+                
+            private:
+                
+                void use_fixed_convolutions(std::true_type)
+                {
+                    this->use_convolutions(&convolve_horizontally_fixed<kernel_size>,&convolve_vertically_fixed<kernel_size>);
+                }
+                
+                void use_fixed_convolutions(std::false_type)
+                {
+                }
+            };
+        }
+    }
+}
+
+#endif //__PANDORA_FILTER_GAUSSIAN_FIXED_H__
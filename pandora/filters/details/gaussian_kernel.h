@@ -0,0 +1,199 @@
+/*BSD 3-Clause License
+
+Copyright (c) 2018, eelcoder
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+* Redistributions of source code must retain the above copyright notice, this
+list of conditions and the following disclaimer.
+
+* Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentation
+and/or other materials provided with the distribution.
+
+* Neither the name of the copyright holder nor the names of its
+contributors may be used to endorse or promote products derived from
+this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+         SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+#ifndef __PANDORA_FILTER_GAUSSIAN_KERNEL_H__
+#define __PANDORA_FILTER_GAUSSIAN_KERNEL_H__
+
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+namespace pandora
+{
+    namespace filter
+    {
+        namespace details
+        {
+            /**
+             * \brief 1D discrete Gaussian kernel.
+             *        G(x,sigma) = exp(- x2/ 2 x sigma2), normalized so that the weights sum to 1.
+             *
+             * \remark the 2D Gaussian kernel is separable : G(x,y,sigma) = G(x,sigma) x G(y,sigma).
+             */
+            class gaussian_kernel
+            {
+                
+            public:
+                
+                //the fixed point weights are Q8 : they sum exactly to 1 << fixed_point_shift
+                static constexpr int fixed_point_shift = 8;
+                
+                /**
+                 * \brief constructor.
+                 *
+                 * \param[in] kernel diameter.
+                 * \param[in] gaussian sigma.
+                 */
+                inline gaussian_kernel(int kernel_size,float sigma):
+                    kernel_radius(kernel_size/2),kernel_sigma(sigma),weights(2*(kernel_size/2)+1)
+                {
+                    const double sigma_squared = static_cast<double>(sigma)*sigma;
+                    
+                    double sum_weight = 0;
+                    std::vector<double> raw_weights(weights.size());
+                    
+                    for (int x = -kernel_radius; x <= kernel_radius; ++x)
+                    {
+                        raw_weights[x+kernel_radius] = std::exp(-((x * x) / (2.0 * sigma_squared)));
+                        sum_weight += raw_weights[x+kernel_radius];
+                    }
+                    
+                    for (std::size_t i = 0; i < weights.size(); ++i)
+                    {
+                        weights[i] = static_cast<float>(raw_weights[i] / sum_weight);
+                    }
+                    
+                    quantize(raw_weights,sum_weight);
+                }
+                
+                /**
+                 * \brief kernel radius, the kernel covers [-radius,radius].
+                 */
+                int radius() const
+                {
+                    return kernel_radius;
+                }
+                
+                /**
+                 * \brief number of taps of the kernel (2 x radius + 1).
+                 */
+                int size() const
+                {
+                    return static_cast<int>(weights.size());
+                }
+                
+                /**
+                 * \brief gaussian sigma.
+                 */
+                float sigma() const
+                {
+                    return kernel_sigma;
+                }
+                
+                /**
+                 * \brief normalized weight of a tap.
+                 *
+                 * \param[in] offset from the kernel center, in [-radius,radius].
+                 * \return normalized weight.
+                 */
+                float operator[](int offset) const
+                {
+                    return weights[offset+kernel_radius];
+                }
+                
+                /**
+                 * \brief normalized weights, from -radius to radius.
+                 */
+                const float* data() const
+                {
+                    return weights.data();
+                }
+                
+                /**
+                 * \brief fixed point weights, from -radius to radius.
+                 */
+                const uint16_t* fixed_data() const
+                {
+                    return fixed_weights.data();
+                }
+                
+            private:
+                
+                /**
+                 * \brief quantize the weights so that they sum exactly to 1 << fixed_point_shift.
+                 *        The weights are rounded down, then the missing units go to the symmetric pairs of
+                 *        taps with the largest remainders (and to the center tap) to keep the kernel symmetric.
+                 *
+                 * \param[in] non normalized weights.
+                 * \param[in] sum of the non normalized weights.
+                 */
+                void quantize(const std::vector<double> &raw_weights,double sum_weight)
+                {
+                    const double one = static_cast<double>(1 << fixed_point_shift);
+                    
+                    fixed_weights.resize(raw_weights.size());
+                    std::vector<double> remainders(raw_weights.size());
+                    int missing = 1 << fixed_point_shift;
+                    
+                    for (std::size_t i = 0; i < raw_weights.size(); ++i)
+                    {
+                        double scaled_weight = raw_weights[i] * one / sum_weight;
+                        fixed_weights[i] = static_cast<uint16_t>(std::floor(scaled_weight));
+                        remainders[i] = scaled_weight - fixed_weights[i];
+                        missing -= fixed_weights[i];
+                    }
+                    
+                    //the odd unit can only go to the center tap
+                    if (missing % 2 != 0)
+                    {
+                        ++fixed_weights[kernel_radius];
+                        --missing;
+                    }
+                    
+                    //the remaining units go by pair, the taps closest to the center win the ties
+                    while (missing > 0)
+                    {
+                        int best = 0;
+                        for (int x = 1; x < kernel_radius; ++x)
+                        {
+                            if (remainders[kernel_radius+x+1] > remainders[kernel_radius+best+1])
+                            {
+                                best = x;
+                            }
+                        }
+                        
+                        const int offset = best+1;
+                        ++fixed_weights[kernel_radius+offset];
+                        ++fixed_weights[kernel_radius-offset];
+                        remainders[kernel_radius+offset] = -1.0;
+                        missing -= 2;
+                    }
+                }
+                
+                int kernel_radius;
+                float kernel_sigma;
+                std::vector<float> weights;
+                std::vector<uint16_t> fixed_weights;
+            };
+        }
+    }
+}
+
+#endif //__PANDORA_FILTER_GAUSSIAN_KERNEL_H__
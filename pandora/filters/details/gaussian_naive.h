@@ -33,7 +33,11 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #define __PANDORA_FILTER_GAUSSIAN_NAIVE_H__
 
 #include <pandora/image.h>
-#include <cmath>
+#include <pandora/region.h>
+#include <pandora/filters/border.h>
+#include <pandora/filters/details/gaussian_kernel.h>
+#include <pandora/filters/details/pixel_traits.h>
+#include <algorithm>
 
 namespace pandora
 {
@@ -45,12 +49,17 @@ namespace pandora
             * \brief Apply a Gaussian filter on a grayscale image.
             *        Naive implementation of the Gaussian filter.
             *
+            * \tparam pixel type : uint8_t, uint16_t or float.
+            * \tparam border policy.
             * \remark for more info, see https://eelcoder.wordpress.com.
             */
+            template<typename pixel_type = uint8_t,typename border = border_clamp>
             class gaussian_naive_impl
             {
 
             public:
+                
+                using image_type = pandora::image<pixel_type>;
 
                 /**
                 * \brief constructor.
@@ -59,25 +68,73 @@ namespace pandora
                 * \param[in] gaussian sigma.
                 */
                 inline gaussian_naive_impl(int kernel_size,float sigma):
-                    kernel_radius(kernel_size/2),sigma_squared(sigma*sigma)
+                    kernel(kernel_size,sigma)
                 {
                 }
                 
                 /**
-                * \brief apply a gaussian filter on a grayscale image.
+                * \brief apply a gaussian filter on all the channels of an image.
                 *
                 * \param[in] input image.
                 * \param[out] output image.
                 */
-                void apply(const pandora::image8u &input_image, pandora::image8u &output_image)
+                void apply(const image_type &input_image, image_type &output_image)
                 {
+                    apply(input_image,output_image,0,input_image.height());
+                }
+                
+                /**
+                 * \brief apply a gaussian filter on a band of rows of all the channels of an image.
+                 *
+                 * \param[in] input image.
+                 * \param[out] output image.
+                 * \param[in] first row of the band.
+                 * \param[in] row following the band.
+                 */
+                void apply(const image_type &input_image, image_type &output_image,int y_begin,int y_end)
+                {
+                    apply(input_image,output_image,pandora::region{0,y_begin,input_image.width(),y_end-y_begin});
+                }
+                
+                /**
+                 * \brief apply a gaussian filter on a region of all the channels of an image.
+                 *        The pixels around the region are read from the image, only the pixels of the region are written.
+                 *
+                 * \param[in] input image.
+                 * \param[out] output image.
+                 * \param[in] region to filter, inside the image.
+                 */
+                void apply(const image_type &input_image, image_type &output_image,const pandora::region &area)
+                {
+                    const int width = input_image.width();
+                    const int height = input_image.height();
+                    const int kernel_radius = kernel.radius();
+                    const int area_begin = area.x;
+                    const int area_end = area.x + area.width;
+                    
                     //apply the gaussian filter
-                    for (auto y = 0; y < input_image.height(); ++y)
+                    for (auto c = 0; c < input_image.spectrum(); ++c)
                     {
-                        for (auto x = 0; x < input_image.width(); ++x)
+                        for (auto y = area.y; y < area.y + area.height; ++y)
                         {
-                            //2d convolution using the discrete Gaussian kernel
-                            output_image(x,y) = convolve(input_image,x,y);
+                            //the kernel reads outside of the image on the kernel_radius pixels along the borders only
+                            const bool interior_row = y >= kernel_radius && y + kernel_radius < height;
+                            const int x_begin = std::max(area_begin,std::min(area_end,interior_row ? kernel_radius : width));
+                            const int x_end = std::max(x_begin,std::min(area_end,interior_row ? width-kernel_radius : width));
+                        
+                            for (auto x = area_begin; x < x_begin; ++x)
+                            {
+                                output_image(x,y,0,c) = convolve_border(input_image,x,y,c);
+                            }
+                            for (auto x = x_begin; x < x_end; ++x)
+                            {
+                                //2d convolution using the discrete Gaussian kernel
+                                output_image(x,y,0,c) = convolve(input_image,x,y,c);
+                            }
+                            for (auto x = x_end; x < area_end; ++x)
+                            {
+                                output_image(x,y,0,c) = convolve_border(input_image,x,y,c);
+                            }
                         }
                     }
                 }
@@ -85,38 +142,67 @@ namespace pandora
             private:
                 
                 /**
-                 * \brief apply a convolution centered on a pixel.
-                 *        2D discrete Gaussian : G(x,y,sigma) = exp(- (x2+y2)/ 2 x sigma2)
+                 * \brief apply a convolution centered on a pixel, the kernel must fit in the image.
+                 *        2D discrete Gaussian : G(x,y,sigma) = G(x,sigma) x G(y,sigma)
                  *
                  * \param[in] input image.
                  * \param[in] x coordinate of the pixel to process.
                  * \param[in] y coordinate of the pixel to process.
+                 * \param[in] channel.
                  * \return smoothen value.
                  */
-                int convolve(const pandora::image8u &input_image,int x_center,int y_center)
+                pixel_type convolve(const image_type &input_image,int x_center,int y_center,int c)
                 {
+                    const int kernel_radius = kernel.radius();
                     float sum = 0;
-                    float sum_weight = 0;
                     
-                    for (int y = -kernel_radius; y < kernel_radius; ++y)
+                    for (int y = -kernel_radius; y <= kernel_radius; ++y)
                     {
-                        for (int x = -kernel_radius; x < kernel_radius; ++x)
+                        float weight_y = kernel[y];
+                        
+                        for (int x = -kernel_radius; x <= kernel_radius; ++x)
                         {
-                            int x_neighbor = std::max(0,std::min(x_center+x,input_image.width()-1));
-                            int y_neighbor = std::max(0,std::min(y_center+y,input_image.height()-1));
-                            
-                            float weight = std::exp(-(((x * x) + (y * y)) / (2.0 * sigma_squared)));
+                            sum += weight_y*kernel[x]*input_image(x_center+x,y_center+y,0,c);
+                        }
+                    }
+                    
+                    //the kernel is normalized, round to the nearest value
+                    return pixel_traits<pixel_type>::from_float(sum);
+                }
+                
+                /**
+                 * \brief apply a convolution centered on a pixel near the borders,
+                 *        the pixels outside of the image are read through the border policy.
+                 *
+                 * \param[in] input image.
+                 * \param[in] x coordinate of the pixel to process.
+                 * \param[in] y coordinate of the pixel to process.
+                 * \param[in] channel.
+                 * \return smoothen value.
+                 */
+                pixel_type convolve_border(const image_type &input_image,int x_center,int y_center,int c)
+                {
+                    const int kernel_radius = kernel.radius();
+                    float sum = 0;
+                    
+                    for (int y = -kernel_radius; y <= kernel_radius; ++y)
+                    {
+                        int y_neighbor = border::index(y_center+y,input_image.height());
+                        float weight_y = kernel[y];
+                        
+                        for (int x = -kernel_radius; x <= kernel_radius; ++x)
+                        {
+                            int x_neighbor = border::index(x_center+x,input_image.width());
                             
-                            sum += weight*input_image(x_neighbor,y_neighbor);
-                            sum_weight += weight;
+                            const float pixel_value = (x_neighbor < 0 || y_neighbor < 0) ? static_cast<float>(border_value<pixel_type,border>()) : input_image(x_neighbor,y_neighbor,0,c);
+                            sum += weight_y*kernel[x]*pixel_value;
                         }
                     }
                     
-                    return static_cast<pandora::image8u::value_type>(sum / sum_weight);
+                    return pixel_traits<pixel_type>::from_float(sum);
                 }
                 
-                int kernel_radius;
-                float sigma_squared;
+                gaussian_kernel kernel;
             };
     }
 }
@@ -32,7 +32,14 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #define __PANDORA_FILTER_GAUSSIAN_SEPARABLE_H__
 
 #include <pandora/image.h>
-#include <cmath>
+#include <pandora/region.h>
+#include <pandora/cpu_features.h>
+#include <pandora/filters/border.h>
+#include <pandora/filters/details/gaussian_kernel.h>
+#include <pandora/filters/details/separable_convolution.h>
+#include <pandora/filters/details/separable_convolution_float.h>
+#include <algorithm>
+#include <vector>
 
 namespace pandora
 {
@@ -40,119 +47,533 @@ namespace pandora
     {
         namespace details
         {
+            /**
+             * \brief arithmetic of the separable filter for a pixel type.
+             *        16 bit and floating point pixels : float weights and float intermediate rows.
+             *
+             * \tparam pixel type.
+             */
+            template<typename pixel_type>
+            struct separable_arithmetic
+            {
+                using intermediate_type = float;
+                using horizontal_pass = void (*)(pandora::simd_level,const pixel_type*,int,const float*,int,int,float*);
+                using vertical_pass = void (*)(pandora::simd_level,const float* const*,int,const float*,int,pixel_type*);
+                
+                static horizontal_pass horizontal()
+                {
+                    return &convolve_horizontally_float<pixel_type>;
+                }
+                
+                static vertical_pass vertical()
+                {
+                    return &convolve_vertically_float<pixel_type>;
+                }
+                
+                static const float* weights(const gaussian_kernel &kernel)
+                {
+                    return kernel.data();
+                }
+                
+                static float filtered_value(pixel_type value)
+                {
+                    return value;
+                }
+            };
+            
+            /**
+             * \brief 8 bit pixels : Q8 weights and Q8 intermediate rows, bit exact.
+             */
+            template<>
+            struct separable_arithmetic<uint8_t>
+            {
+                using intermediate_type = uint16_t;
+                using horizontal_pass = horizontal_convolution;
+                using vertical_pass = vertical_convolution;
+                
+                static horizontal_pass horizontal()
+                {
+                    return &convolve_horizontally;
+                }
+                
+                static vertical_pass vertical()
+                {
+                    return &convolve_vertically;
+                }
+                
+                static const uint16_t* weights(const gaussian_kernel &kernel)
+                {
+                    return kernel.fixed_data();
+                }
+                
+                static uint16_t filtered_value(uint8_t value)
+                {
+                    return static_cast<uint16_t>(value << gaussian_kernel::fixed_point_shift);
+                }
+            };
+            
             /**
              * \brief Apply a Gaussian filter on a grayscale image.
              *        Implementation of the Separable Gaussian filter.
              *
+             *        Both passes walk the image row by row : each input row is filtered horizontally
+             *        into a ring buffer of kernel_size rows, and each output row is the vertical
+             *        convolution of the sliding window of rows held by the ring buffer.
+             *        The ring buffer is indexed by virtual rows, from -kernel_radius to height + kernel_radius :
+             *        the rows outside of the image are produced once through the border policy, so neither
+             *        pass tests the borders inside its pixel loop.
+             *        For 8 bit pixels the arithmetic is integer only : Q8 weights summing exactly to 256, a 16 bit
+             *        intermediate and a single rounding to the nearest value, so the output is bit exact
+             *        whatever the compiler or the instruction set.
+             *        16 bit and floating point pixels use float weights and float intermediate rows,
+             *        the 16 bit output is rounded to the nearest value and saturated.
+             *        The channels of an image are filtered one after the other, the interleaved channels
+             *        (apply_interleaved) are filtered together.
+             *        The horizontal and the vertical passes have their own kernel, so the filter may be anisotropic
+             *        (sigma_x != sigma_y) at the cost of an isotropic one.
+             *
+             * \tparam pixel type : uint8_t, uint16_t or float.
+             * \tparam border policy.
              * \remark for more info, see https://eelcoder.wordpress.com.
              */
+            template<typename pixel_type = uint8_t,typename border = border_clamp>
             class gaussian_separable_impl
             {
+                using arithmetic = separable_arithmetic<pixel_type>;
                 
             public:
                 
+                using image_type = pandora::image<pixel_type>;
+                using intermediate_type = typename arithmetic::intermediate_type;
+                
                 /**
                  * \brief constructor.
+                 *        The image size only sizes the scratch buffers up front : any image size can be filtered
+                 *        afterwards, the buffers grow to the largest rows met and are then reused as is.
                  *
-                 * \param[in] image width.
-                 * \param[in] image height.
+                 * \param[in] image width, 0 if unknown.
+                 * \param[in] image height, unused.
                  * \param[in] kernel size.
                  * \param[in] gaussian sigma.
+                 * \param[in] instruction set to use, limited to the ones supported by the cpu.
+                 */
+                inline gaussian_separable_impl(int image_width,int image_height,int kernel_size,float sigma,
+                                               pandora::simd_level requested_level = pandora::simd_level::scalar):
+                        gaussian_separable_impl(image_width,image_height,kernel_size,sigma,kernel_size,sigma,requested_level)
+                {
+                }
+                
+                /**
+                 * \brief constructor of an anisotropic filter : each axis has its own kernel size and sigma.
+                 *
+                 * \param[in] image width, 0 if unknown.
+                 * \param[in] image height, unused.
+                 * \param[in] horizontal kernel size.
+                 * \param[in] horizontal gaussian sigma.
+                 * \param[in] vertical kernel size.
+                 * \param[in] vertical gaussian sigma.
+                 * \param[in] instruction set to use, limited to the ones supported by the cpu.
+                 */
+                inline gaussian_separable_impl(int image_width,int /*image_height*/,int kernel_size_x,float sigma_x,int kernel_size_y,float sigma_y,
+                                               pandora::simd_level requested_level = pandora::simd_level::scalar):
+                        horizontal_kernel(kernel_size_x,sigma_x),
+                        vertical_kernel(kernel_size_y,sigma_y),
+                        level(std::min(requested_level,pandora::cpu_simd_level())),
+                        window(vertical_kernel.size()),
+                        horizontal_pass(arithmetic::horizontal()),
+                        vertical_pass(arithmetic::vertical())
+                {
+                    reserve(tile_columns(image_width,1));
+                }
+                
+                /**
+                 * \brief apply a gaussian filter on all the channels of an image.
+                 *
+                 * \param[in] input image.
+                 * \param[out] output image.
+                 */
+                void apply(const image_type &input_image, image_type &output_image)
+                {
+                    apply(input_image,output_image,0,input_image.height());
+                }
+                
+                /**
+                 * \brief apply a gaussian filter on a band of rows of all the channels of an image.
+                 *        The kernel_radius rows around the band are read as a halo.
+                 *        When the ring buffer of a whole row does not fit in the cache, the band is processed
+                 *        in tiles of columns (with a halo of kernel_radius columns), so the horizontally filtered
+                 *        rows are consumed by the vertical pass before leaving the cache.
+                 *
+                 * \param[in] input image.
+                 * \param[out] output image.
+                 * \param[in] first row of the band.
+                 * \param[in] row following the band.
                  */
-                inline gaussian_separable_impl(int image_width,int image_height,int kernel_size,float sigma):
-                        kernel_radius(kernel_size/2),sigma_squared(sigma*sigma),
-                        horizontal_image(image_width,image_height,1,1,0)
+                void apply(const image_type &input_image, image_type &output_image,int y_begin,int y_end)
                 {
+                    for (int c = 0; c < input_image.spectrum(); ++c)
+                    {
+                        apply_plane(input_image.data(0,0,0,c),output_image.data(0,0,0,c),input_image.width(),input_image.height(),1,
+                                    0,input_image.width(),y_begin,y_end);
+                    }
                 }
                 
                 /**
-                 * \brief apply a gaussian filter on a grayscale image.
+                 * \brief apply a gaussian filter on a region of all the channels of an image.
+                 *        The kernel_radius pixels around the region are read from the image as a halo (or through
+                 *        the border policy along the image borders), only the pixels of the region are written.
                  *
                  * \param[in] input image.
                  * \param[out] output image.
+                 * \param[in] region to filter, inside the image.
                  */
-                void apply(const pandora::image8u &input_image, pandora::image8u &output_image)
+                void apply(const image_type &input_image, image_type &output_image,const pandora::region &area)
                 {
-                    //apply the horizontal 1D gaussian filter
-                    for (auto y = 0; y < input_image.height(); ++y)
+                    for (int c = 0; c < input_image.spectrum(); ++c)
                     {
-                        for (auto x = 0; x < input_image.width(); ++x)
-                        {
-                            //1d convolution using the discrete Gaussian kernel
-                            horizontal_image(x,y) = convolve_horizontally(input_image,x,y);
-                        }
+                        apply_plane(input_image.data(0,0,0,c),output_image.data(0,0,0,c),input_image.width(),input_image.height(),1,
+                                    area.x,area.x+area.width,area.y,area.y+area.height);
                     }
+                }
+                
+                /**
+                 * \brief apply a gaussian filter on an image of interleaved channels (r g b r g b ...) :
+                 *        each row of the image holds width x channel_count values.
+                 *        The channels are filtered together, the taps of the horizontal pass are channel_count
+                 *        values apart, so each vector holds the consecutive values of several channels.
+                 *
+                 * \param[in] input image, width x channel_count values per row.
+                 * \param[out] output image.
+                 * \param[in] number of interleaved channels.
+                 */
+                void apply_interleaved(const image_type &input_image, image_type &output_image,int channel_count)
+                {
+                    apply_interleaved(input_image,output_image,channel_count,0,input_image.height());
+                }
+                
+                /**
+                 * \brief apply a gaussian filter on a band of rows of an image of interleaved channels.
+                 *
+                 * \param[in] input image, width x channel_count values per row.
+                 * \param[out] output image.
+                 * \param[in] number of interleaved channels.
+                 * \param[in] first row of the band.
+                 * \param[in] row following the band.
+                 */
+                void apply_interleaved(const image_type &input_image, image_type &output_image,int channel_count,int y_begin,int y_end)
+                {
+                    apply_plane(input_image.data(),output_image.data(),input_image.width()/channel_count,input_image.height(),
+                                channel_count,0,input_image.width()/channel_count,y_begin,y_end);
+                }
+                
+                /**
+                 * \brief apply the horizontal pass on an input row and keep it in the ring buffer.
+                 *        The ring buffer holds the kernel_size last rows.
+                 *
+                 * \param[in] input row.
+                 * \param[in] row width.
+                 * \param[in] virtual row index, from -kernel_radius.
+                 */
+                void filter_row_horizontally(const pixel_type* input_row,int width,int y)
+                {
+                    filter_row_horizontally(input_row,width,0,width,y);
+                }
+                
+                /**
+                 * \brief apply the horizontal pass on the columns [x_begin,x_end) of an input row and keep
+                 *        them at the start of a row of the ring buffer.
+                 *
+                 * \param[in] input row.
+                 * \param[in] row width, in pixels.
+                 * \param[in] first column.
+                 * \param[in] column following the last one.
+                 * \param[in] virtual row index, from -kernel_radius.
+                 * \param[in] number of interleaved channels.
+                 */
+                void filter_row_horizontally(const pixel_type* input_row,int width,int x_begin,int x_end,int y,int channel_count = 1)
+                {
+                    convolve_row_horizontally(input_row,width,x_begin,x_end,ring_row(y),channel_count);
+                }
+                
+                /**
+                 * \brief apply the horizontal pass on the columns [x_begin,x_end) of an input row, outside of the ring buffer.
+                 *
+                 * \param[in] input row.
+                 * \param[in] row width, in pixels.
+                 * \param[in] first column.
+                 * \param[in] column following the last one.
+                 * \param[out] horizontally filtered columns, (x_end - x_begin) x channel_count values.
+                 * \param[in] number of interleaved channels.
+                 */
+                void convolve_row_horizontally(const pixel_type* input_row,int width,int x_begin,int x_end,intermediate_type* output_row,
+                                               int channel_count = 1)
+                {
+                    pad_row<border>(input_row,width,x_begin,x_end,horizontal_kernel.radius(),padded_row.data(),channel_count);
+                    horizontal_pass(level,padded_row.data(),(x_end-x_begin)*channel_count,arithmetic::weights(horizontal_kernel),
+                                    horizontal_kernel.size(),channel_count,output_row);
+                }
+                
+                /**
+                 * \brief copy a row of the ring buffer to another virtual row, instead of filtering the
+                 *        same input row again.
+                 *
+                 * \param[in] virtual row index held by the ring buffer.
+                 * \param[in] virtual row index to set.
+                 * \param[in] row width, in values : width x channel_count for interleaved channels.
+                 */
+                void copy_filtered_row(int y_source,int y,int width)
+                {
+                    std::copy(ring_row(y_source),ring_row(y_source)+width,ring_row(y));
+                }
+                
+                /**
+                 * \brief apply the vertical pass on the rows of the ring buffer centered on a row.
+                 *        The virtual rows y - kernel_radius to y + kernel_radius must have been filtered horizontally.
+                 *
+                 * \param[in] row to process.
+                 * \param[in] row width, in values : width x channel_count for interleaved channels.
+                 * \param[out] output row.
+                 */
+                void filter_row_vertically(int y,int width,pixel_type* output_row)
+                {
+                    const int kernel_radius = vertical_kernel.radius();
                     
-                    //apply the vertical 1D gaussian filter
-                    for (auto x = 0; x < input_image.width(); ++x)
+                    //gather the rows of the sliding window
+                    for (int k = -kernel_radius; k <= kernel_radius; ++k)
                     {
-                        for (auto y = 0; y < input_image.height(); ++y)
-                        {
-                            //1d convolution using the discrete Gaussian kernel
-                            output_image(x,y) = convolve_vertically(horizontal_image,x,y);
-                        }
+                        window[k+kernel_radius] = ring_row(y+k);
                     }
+                    
+                    convolve_rows_vertically(window.data(),width,output_row);
                 }
                 
-            private:
+                /**
+                 * \brief apply the vertical pass on kernel_size horizontally filtered rows, outside of the ring buffer.
+                 *
+                 * \param[in] rows of the sliding window, from y - kernel_radius to y + kernel_radius.
+                 * \param[in] row width, in values.
+                 * \param[out] output row.
+                 */
+                void convolve_rows_vertically(const intermediate_type* const* rows,int width,pixel_type* output_row)
+                {
+                    vertical_pass(level,rows,width,arithmetic::weights(vertical_kernel),vertical_kernel.size(),output_row);
+                }
+                
+                /**
+                 * \brief horizontally filtered value of the rows outside of the image, for a constant border.
+                 */
+                static intermediate_type filtered_border_value()
+                {
+                    return arithmetic::filtered_value(border_value<pixel_type,border>());
+                }
                 
                 /**
-                 * \brief apply a 1D Gaussian convolution on a pixel.
-                 *        1D discrete Gaussian Kernel: G(x,sigma) = exp(- x2/ 2 x sigma2)
+                 * \brief make room for rows of width pixels in the padded row and the ring buffer, the rows
+                 *        passed to filter_row_horizontally must not be wider. The buffers only grow : once
+                 *        they hold the largest rows, filtering any image does not allocate anymore.
+                 *        apply and apply_interleaved call it, the streaming filter calls it once.
                  *
-                 * \param[in] input image.
-                 * \param[in] x coordinate of the pixel to process.
-                 * \param[in] y coordinate of the pixel to process.
-                 * \return smoothen value.
+                 * \param[in] row width, in pixels.
+                 * \param[in] number of interleaved channels.
+                 */
+                void reserve(int width,int channel_count = 1)
+                {
+                    const std::size_t padded_size = static_cast<std::size_t>(width+2*horizontal_kernel.radius())*channel_count;
+                    if (padded_row.size() < padded_size)
+                    {
+                        padded_row.resize(padded_size);
+                    }
+                    if (horizontal_image.width() < width*channel_count)
+                    {
+                        horizontal_image.assign(width*channel_count,vertical_kernel.size(),1,1,0);
+                    }
+                }
+                
+                /**
+                 * \brief gaussian kernel of an isotropic filter, the horizontal kernel otherwise.
+                 */
+                const gaussian_kernel& get_kernel() const
+                {
+                    return horizontal_kernel;
+                }
+                
+                /**
+                 * \brief gaussian kernel of the horizontal pass.
+                 */
+                const gaussian_kernel& get_horizontal_kernel() const
+                {
+                    return horizontal_kernel;
+                }
+                
+                /**
+                 * \brief gaussian kernel of the vertical pass, it sets the number of rows of the ring buffer.
+                 */
+                const gaussian_kernel& get_vertical_kernel() const
+                {
+                    return vertical_kernel;
+                }
+                
+                /**
+                 * \brief apply the horizontal pass on the columns of a virtual row, read through the border policy.
+                 *        Consecutive virtual rows reading the same input row (replicated border) are copied.
+                 *        apply calls it on the rows entering the ring buffer, the filters driving the passes row
+                 *        by row call it the same way.
+                 *
+                 * \param[in] input plane.
+                 * \param[in] plane width, in pixels.
+                 * \param[in] plane height.
+                 * \param[in] number of interleaved channels.
+                 * \param[in] first column.
+                 * \param[in] column following the last one.
+                 * \param[in] virtual row index.
+                 * \param[in,out] input row of the previous virtual row, -1 if none.
                  */
-                int convolve_horizontally(const pandora::image8u &input_image,int x_center,int y_center)
+                void filter_virtual_row(const pixel_type* input,int width,int height,int channel_count,
+                                        int x_begin,int x_end,int y,int &previous_source)
                 {
-                    float sum = 0;
-                    float sum_weight = 0;
+                    const int source = border::index(y,height);
+                    const int row_size = (x_end-x_begin)*channel_count;
                     
-                    for (int x = -kernel_radius; x < kernel_radius; ++x)
+                    if (source < 0)
                     {
-                        int x_neighbor = std::max(0,std::min(x_center+x,input_image.width()-1));
-                        
-                        float weight = std::exp(-(((x * x)) / (2.0 * sigma_squared)));
-                        
-                        sum += weight*input_image(x_neighbor,y_center);
-                        sum_weight += weight;
+                        const intermediate_type constant_value = filtered_border_value();
+                        std::fill(ring_row(y),ring_row(y)+row_size,constant_value);
                     }
+                    else if (source == previous_source)
+                    {
+                        copy_filtered_row(y-1,y,row_size);
+                    }
+                    else
+                    {
+                        filter_row_horizontally(input+static_cast<std::size_t>(source)*width*channel_count,width,x_begin,x_end,y,channel_count);
+                    }
+                    previous_source = source;
+                }
+                
+                /**
+                 * \brief width of the column tiles : the whole row when the ring buffer fits in ring_cache_bytes,
+                 *        otherwise the largest multiple of 64 columns that fits.
+                 *        The filters driving the passes row by row tile their images with it too.
+                 *
+                 * \param[in] image width.
+                 * \param[in] number of interleaved channels.
+                 * \return tile width.
+                 */
+                int tile_columns(int width,int channel_count) const
+                {
+                    const int ring_column_bytes = vertical_kernel.size()*channel_count*static_cast<int>(sizeof(intermediate_type));
+                    if (width*ring_column_bytes <= ring_cache_bytes)
+                    {
+                        return width;
+                    }
+                    return std::max(64,(ring_cache_bytes/ring_column_bytes) & ~63);
+                }
+                
+            protected:
+                
+                /**
+                 * \brief replace the row convolutions, by ones specialized for the kernel sizes.
+                 *        They must produce the same output as convolve_horizontally and convolve_vertically.
+                 *
+                 * \param[in] horizontal pass, nullptr to keep the current one.
+                 * \param[in] vertical pass, nullptr to keep the current one.
+                 */
+                void use_convolutions(typename arithmetic::horizontal_pass horizontal,typename arithmetic::vertical_pass vertical)
+                {
+                    if (horizontal)
+                    {
+                        horizontal_pass = horizontal;
+                    }
+                    if (vertical)
+                    {
+                        vertical_pass = vertical;
+                    }
+                }
+                
+            private:
+                
+                /**
+                 * \brief apply a gaussian filter on a region of an image plane, tile by tile.
+                 *
+                 * \param[in] input plane.
+                 * \param[out] output plane.
+                 * \param[in] plane width, in pixels.
+                 * \param[in] plane height.
+                 * \param[in] number of interleaved channels.
+                 * \param[in] first column of the region.
+                 * \param[in] column following the region.
+                 * \param[in] first row of the region.
+                 * \param[in] row following the region.
+                 */
+                void apply_plane(const pixel_type* input,pixel_type* output,int width,int height,int channel_count,
+                                 int x_begin,int x_end,int y_begin,int y_end)
+                {
+                    const int tile_width = tile_columns(x_end-x_begin,channel_count);
+                    reserve(tile_width,channel_count);
                     
-                    return static_cast<pandora::image8u::value_type>(sum / sum_weight);
+                    for (int x = x_begin; x < x_end; x += tile_width)
+                    {
+                        apply_tile(input,output,width,height,channel_count,x,std::min(x_end,x+tile_width),y_begin,y_end);
+                    }
                 }
                 
                 /**
-                 * \brief apply a 1D Gaussian convolution on a pixel.
-                 *        1D discrete Gaussian Kernel: G(y,sigma) = exp(- y2/ 2 x sigma2)
+                 * \brief apply a gaussian filter on a tile of an image plane.
                  *
-                 * \param[in] input image.
-                 * \param[in] x coordinate of the pixel to process.
-                 * \param[in] y coordinate of the pixel to process.
-                 * \return smoothen value.
+                 * \param[in] input plane.
+                 * \param[out] output plane.
+                 * \param[in] plane width, in pixels.
+                 * \param[in] plane height.
+                 * \param[in] number of interleaved channels.
+                 * \param[in] first column of the tile.
+                 * \param[in] column following the tile.
+                 * \param[in] first row of the tile.
+                 * \param[in] row following the tile.
                  */
-                int convolve_vertically(const pandora::image8u &input_image,int x_center,int y_center)
+                void apply_tile(const pixel_type* input,pixel_type* output,int width,int height,int channel_count,
+                                int x_begin,int x_end,int y_begin,int y_end)
                 {
-                    float sum = 0;
-                    float sum_weight = 0;
+                    const int kernel_radius = vertical_kernel.radius();
+                    const int row_size = width*channel_count;
                     
-                    for (int y = -kernel_radius; y < kernel_radius; ++y)
+                    int previous_source = -1;
+                    for (int y = y_begin-kernel_radius; y < y_begin+kernel_radius; ++y)
                     {
-                        int y_neighbor = std::max(0,std::min(y_center+y,input_image.height()-1));
-                        
-                        float weight = std::exp(-(((y * y)) / (2.0 * sigma_squared)));
-                        
-                        sum += weight*input_image(x_center,y_neighbor);
-                        sum_weight += weight;
+                        filter_virtual_row(input,width,height,channel_count,x_begin,x_end,y,previous_source);
                     }
                     
-                    return static_cast<pandora::image8u::value_type>(sum / sum_weight);
+                    for (auto y = y_begin; y < y_end; ++y)
+                    {
+                        //apply the horizontal 1D gaussian filter on the row entering the window
+                        filter_virtual_row(input,width,height,channel_count,x_begin,x_end,y+kernel_radius,previous_source);
+                        
+                        //apply the vertical 1D gaussian filter
+                        filter_row_vertically(y,(x_end-x_begin)*channel_count,output+static_cast<std::size_t>(y)*row_size+x_begin*channel_count);
+                    }
                 }
                 
-                int kernel_radius;
-                float sigma_squared;
-                pandora::image8u horizontal_image;
+                /**
+                 * \brief row of the ring buffer holding a horizontally filtered virtual row.
+                 *
+                 * \param[in] virtual row index, from -kernel_size.
+                 * \return row of the ring buffer.
+                 */
+                intermediate_type* ring_row(int y)
+                {
+                    return horizontal_image.data(0,(y + vertical_kernel.size()) % vertical_kernel.size());
+                }
+                
+                //budget of the ring buffer, about half of a L2 cache : the input and output rows need the rest
+                static constexpr int ring_cache_bytes = 128*1024;
+                
+                gaussian_kernel horizontal_kernel;
+                gaussian_kernel vertical_kernel;
+                pandora::simd_level level;
+                std::vector<pixel_type> padded_row;
+                pandora::image<intermediate_type> horizontal_image;
+                std::vector<const intermediate_type*> window;
+                typename arithmetic::horizontal_pass horizontal_pass;
+                typename arithmetic::vertical_pass vertical_pass;
             };
         }
     }
@@ -0,0 +1,120 @@
+/*BSD 3-Clause License
+
+Copyright (c) 2018, eelcoder
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+* Redistributions of source code must retain the above copyright notice, this
+list of conditions and the following disclaimer.
+
+* Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentation
+and/or other materials provided with the distribution.
+
+* Neither the name of the copyright holder nor the names of its
+contributors may be used to endorse or promote products derived from
+this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+         SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+#ifndef __PANDORA_FILTER_GAUSSIAN_SIMD_H__
+#define __PANDORA_FILTER_GAUSSIAN_SIMD_H__
+
+#include <pandora/image.h>
+#include <pandora/cpu_features.h>
+#include <pandora/filters/details/gaussian_separable.h>
+#include <pandora/filters/details/separable_convolution.h>
+#include <type_traits>
+
+namespace pandora
+{
+    namespace filter
+    {
+        namespace details
+        {
+            /**
+             * \brief Apply a Gaussian filter on a grayscale image.
+             *        Vectorized implementation of the Separable Gaussian filter.
+             *
+             *        Same fixed point arithmetic as gaussian_separable_impl, the rows are convolved 16 or 32
+             *        pixels at a time with the best instruction set (AVX2, SSE4.1) detected at runtime.
+             *        The usual kernel sizes (3, 5 and 7) run the row convolutions of gaussian_fixed_impl.
+             *        All the code paths produce the same output.
+             *        16 bit and floating point pixels run the float row convolutions, 8 or 16 pixels at a time.
+             *
+             * \tparam pixel type : uint8_t, uint16_t or float.
+             * \tparam border policy.
+             * \remark for more info, see https://eelcoder.wordpress.com.
+             */
+            template<typename pixel_type = uint8_t,typename border = border_clamp>
+            class gaussian_simd_impl : public gaussian_separable_impl<pixel_type,border>
+            {
+                
+            public:
+                
+                /**
+                 * \brief constructor.
+                 *
+                 * \param[in] image width.
+                 * \param[in] image height.
+                 * \param[in] kernel size.
+                 * \param[in] gaussian sigma.
+                 * \param[in] instruction set to use, limited to the ones supported by the cpu.
+                 */
+                inline gaussian_simd_impl(int image_width,int image_height,int kernel_size,float sigma,
+                                          pandora::simd_level requested_level = pandora::cpu_simd_level()):
+                        gaussian_separable_impl<pixel_type,border>(image_width,image_height,kernel_size,sigma,requested_level)
+                {
+                    use_fixed_convolutions(std::is_same<pixel_type,uint8_t>());
+                }
+                
+                /**
+                 * \brief constructor of an anisotropic filter : each axis has its own kernel size and sigma.
+                 *
+                 * \param[in] image width.
+                 * \param[in] image height.
+                 * \param[in] horizontal kernel size.
+                 * \param[in] horizontal gaussian sigma.
+                 * \param[in] vertical kernel size.
+                 * \param[in] vertical gaussian sigma.
+                 * \param[in] instruction set to use, limited to the ones supported by the cpu.
+                 */
+                inline gaussian_simd_impl(int image_width,int image_height,int kernel_size_x,float sigma_x,int kernel_size_y,float sigma_y,
+                                          pandora::simd_level requested_level = pandora::cpu_simd_level()):
+                        gaussian_separable_impl<pixel_type,border>(image_width,image_height,kernel_size_x,sigma_x,kernel_size_y,sigma_y,requested_level)
+                {
+                    use_fixed_convolutions(std::is_same<pixel_type,uint8_t>());
+                }
+                
+            private:
+                
+                /**
+                 * \brief use the row convolutions specialized for the usual kernel sizes, 8 bit pixels only.
+                 *        Each axis picks its own, an anisotropic filter may specialize one pass only.
+                 */
+                void use_fixed_convolutions(std::true_type)
+                {
+                    this->use_convolutions(fixed_horizontal_convolution(this->get_horizontal_kernel().size()),
+                                           fixed_vertical_convolution(this->get_vertical_kernel().size()));
+                }
+                
+                void use_fixed_convolutions(std::false_type)
+                {
+                }
+            };
+        }
+    }
+}
+
+#endif //__PANDORA_FILTER_GAUSSIAN_SIMD_H__
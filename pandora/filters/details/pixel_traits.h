@@ -0,0 +1,94 @@
+/*BSD 3-Clause License
+
+Copyright (c) 2018, eelcoder
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+* Redistributions of source code must retain the above copyright notice, this
+list of conditions and the following disclaimer.
+
+* Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentation
+and/or other materials provided with the distribution.
+
+* Neither the name of the copyright holder nor the names of its
+contributors may be used to endorse or promote products derived from
+this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+         SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+#ifndef __PANDORA_FILTER_PIXEL_TRAITS_H__
+#define __PANDORA_FILTER_PIXEL_TRAITS_H__
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+
+namespace pandora
+{
+    namespace filter
+    {
+        namespace details
+        {
+            /**
+             * \brief conversion of the filtered values, computed in floating point, back to a pixel type.
+             *        Integer pixels are rounded to the nearest value and saturated to their range.
+             *
+             * \tparam pixel type : uint8_t, uint16_t.
+             */
+            template<typename pixel_type>
+            struct pixel_traits
+            {
+                /**
+                 * \brief round and saturate a filtered value.
+                 *
+                 * \param[in] filtered value.
+                 * \return pixel value.
+                 */
+                static pixel_type from_float(float value)
+                {
+                    const float max_value = static_cast<float>(std::numeric_limits<pixel_type>::max());
+                    return static_cast<pixel_type>(std::max(0.f,std::min(max_value,value + 0.5f)));
+                }
+            };
+            
+            /**
+             * \brief floating point pixels keep the filtered value as is.
+             */
+            template<>
+            struct pixel_traits<float>
+            {
+                static float from_float(float value)
+                {
+                    return value;
+                }
+            };
+            
+            /**
+             * \brief value of the pixels outside of the image of a border policy, converted to a pixel type.
+             *
+             * \tparam pixel type.
+             * \tparam border policy.
+             * \return border value, rounded and saturated for the integer pixels.
+             */
+            template<typename pixel_type,typename border>
+            inline pixel_type border_value()
+            {
+                return pixel_traits<pixel_type>::from_float(border::value);
+            }
+        }
+    }
+}
+
+#endif //__PANDORA_FILTER_PIXEL_TRAITS_H__
@@ -0,0 +1,632 @@
+/*BSD 3-Clause License
+
+Copyright (c) 2018, eelcoder
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+* Redistributions of source code must retain the above copyright notice, this
+list of conditions and the following disclaimer.
+
+* Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentation
+and/or other materials provided with the distribution.
+
+* Neither the name of the copyright holder nor the names of its
+contributors may be used to endorse or promote products derived from
+this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+         SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+#ifndef __PANDORA_FILTER_SEPARABLE_CONVOLUTION_H__
+#define __PANDORA_FILTER_SEPARABLE_CONVOLUTION_H__
+
+#include <pandora/cpu_features.h>
+#include <pandora/filters/border.h>
+#include <pandora/filters/details/gaussian_kernel.h>
+#include <pandora/filters/details/pixel_traits.h>
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+
+namespace pandora
+{
+    namespace filter
+    {
+        namespace details
+        {
+            //the weights of both passes are Q8, the vertical pass rounds the Q16 sum to the nearest value
+            constexpr int separable_output_shift = 2*gaussian_kernel::fixed_point_shift;
+            constexpr int separable_output_rounding = 1 << (separable_output_shift-1);
+            
+            /**
+             * \brief copy the pixel at a column of a row of interleaved channels, read through the border policy.
+             */
+            template<typename border,typename pixel_type>
+            inline void pad_pixel(const pixel_type* input_row,int width,int x,int channel_count,pixel_type* padded_pixel)
+            {
+                const int source = border::index(x,width);
+                for (int c = 0; c < channel_count; ++c)
+                {
+                    padded_pixel[c] = (source < 0) ? border_value<pixel_type,border>() : input_row[source*channel_count+c];
+                }
+            }
+            
+            /**
+             * \brief copy the columns [x_begin,x_end) of an input row with kernel_radius pixels on each side,
+             *        the pixels outside of the row are read through the border policy,
+             *        so the horizontal pass does not need to handle the borders.
+             *
+             * \tparam border policy.
+             * \tparam pixel type.
+             * \param[in] input row.
+             * \param[in] row width, in pixels.
+             * \param[in] first column.
+             * \param[in] column following the last one.
+             * \param[in] kernel radius.
+             * \param[out] padded row, (x_end - x_begin + 2 x kernel_radius) x channel_count values.
+             * \param[in] number of interleaved channels per pixel.
+             */
+            template<typename border = border_clamp,typename pixel_type>
+            inline void pad_row(const pixel_type* input_row,int width,int x_begin,int x_end,int kernel_radius,pixel_type* padded_row,
+                                int channel_count = 1)
+            {
+                const int copy_begin = std::max(0,x_begin-kernel_radius);
+                const int copy_end = std::min(width,x_end+kernel_radius);
+                
+                //padded_row[0] is the column x_begin - kernel_radius
+                const int offset = kernel_radius-x_begin;
+                for (int x = x_begin-kernel_radius; x < copy_begin; ++x)
+                {
+                    pad_pixel<border>(input_row,width,x,channel_count,padded_row+(x+offset)*channel_count);
+                }
+                std::memcpy(padded_row+(copy_begin+offset)*channel_count,input_row+copy_begin*channel_count,
+                            (copy_end-copy_begin)*channel_count*sizeof(pixel_type));
+                for (int x = copy_end; x < x_end+kernel_radius; ++x)
+                {
+                    pad_pixel<border>(input_row,width,x,channel_count,padded_row+(x+offset)*channel_count);
+                }
+            }
+            
+#if defined(PANDORA_X86)
+            /**
+             * \brief horizontal pass, 32 pixels per iteration.
+             *        The sum of the u8 x Q8 products is at most 255 x 256 and fits exactly in 16 bits.
+             *
+             * \return number of pixels processed.
+             */
+            PANDORA_TARGET("avx2")
+            inline int convolve_horizontally_avx2(const uint8_t* input_row,int width,const uint16_t* weights,
+                                                  int kernel_size,int pixel_stride,uint16_t* output_row)
+            {
+                int x = 0;
+                for (; x + 32 <= width; x += 32)
+                {
+                    __m256i sum_low = _mm256_setzero_si256();
+                    __m256i sum_high = _mm256_setzero_si256();
+                    
+                    for (int k = 0; k < kernel_size; ++k)
+                    {
+                        const __m256i weight = _mm256_set1_epi16(static_cast<short>(weights[k]));
+                        const uint8_t* tap = input_row+x+k*pixel_stride;
+                        const __m128i pixels_low = _mm_loadu_si128(reinterpret_cast<const __m128i*>(tap));
+                        const __m128i pixels_high = _mm_loadu_si128(reinterpret_cast<const __m128i*>(tap+16));
+                        
+                        sum_low = _mm256_add_epi16(sum_low,_mm256_mullo_epi16(_mm256_cvtepu8_epi16(pixels_low),weight));
+                        sum_high = _mm256_add_epi16(sum_high,_mm256_mullo_epi16(_mm256_cvtepu8_epi16(pixels_high),weight));
+                    }
+                    
+                    _mm256_storeu_si256(reinterpret_cast<__m256i*>(output_row+x),sum_low);
+                    _mm256_storeu_si256(reinterpret_cast<__m256i*>(output_row+x+16),sum_high);
+                }
+                return x;
+            }
+            
+            /**
+             * \brief horizontal pass, 16 pixels per iteration.
+             *
+             * \return number of pixels processed.
+             */
+            PANDORA_TARGET("sse4.1")
+            inline int convolve_horizontally_sse41(const uint8_t* input_row,int width,const uint16_t* weights,
+                                                   int kernel_size,int pixel_stride,uint16_t* output_row)
+            {
+                const __m128i zero = _mm_setzero_si128();
+                
+                int x = 0;
+                for (; x + 16 <= width; x += 16)
+                {
+                    __m128i sum_low = _mm_setzero_si128();
+                    __m128i sum_high = _mm_setzero_si128();
+                    
+                    for (int k = 0; k < kernel_size; ++k)
+                    {
+                        const __m128i weight = _mm_set1_epi16(static_cast<short>(weights[k]));
+                        const __m128i pixels = _mm_loadu_si128(reinterpret_cast<const __m128i*>(input_row+x+k*pixel_stride));
+                        
+                        sum_low = _mm_add_epi16(sum_low,_mm_mullo_epi16(_mm_cvtepu8_epi16(pixels),weight));
+                        sum_high = _mm_add_epi16(sum_high,_mm_mullo_epi16(_mm_unpackhi_epi8(pixels,zero),weight));
+                    }
+                    
+                    _mm_storeu_si128(reinterpret_cast<__m128i*>(output_row+x),sum_low);
+                    _mm_storeu_si128(reinterpret_cast<__m128i*>(output_row+x+8),sum_high);
+                }
+                return x;
+            }
+            
+            /**
+             * \brief vertical pass, 16 pixels per iteration.
+             *        The Q8 intermediate values are biased to signed 16 bits (h - 32768) so that two rows
+             *        are multiplied and added at once with madd, the bias is removed through the initial
+             *        value of the accumulator : sum(w x 32768) = 256 x 32768.
+             *
+             * \return number of pixels processed.
+             */
+            PANDORA_TARGET("avx2")
+            inline int convolve_vertically_avx2(const uint16_t* const* rows,int width,const uint16_t* weights,
+                                                int kernel_size,uint8_t* output_row)
+            {
+                const __m256i bias = _mm256_set1_epi16(static_cast<short>(0x8000));
+                const __m256i initial_sum = _mm256_set1_epi32((32768 << gaussian_kernel::fixed_point_shift) + separable_output_rounding);
+                
+                int x = 0;
+                for (; x + 16 <= width; x += 16)
+                {
+                    __m256i sum_low = initial_sum;
+                    __m256i sum_high = initial_sum;
+                    
+                    for (int k = 0; k < kernel_size; k += 2)
+                    {
+                        //an odd kernel ends with a pair made of the last row with a null weight
+                        const int k_next = std::min(k+1,kernel_size-1);
+                        const int weight_next = (k+1 < kernel_size) ? weights[k+1] : 0;
+                        const __m256i weight = _mm256_set1_epi32((weight_next << 16) | weights[k]);
+                        
+                        const __m256i row = _mm256_xor_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(rows[k]+x)),bias);
+                        const __m256i row_next = _mm256_xor_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(rows[k_next]+x)),bias);
+                        
+                        sum_low = _mm256_add_epi32(sum_low,_mm256_madd_epi16(_mm256_unpacklo_epi16(row,row_next),weight));
+                        sum_high = _mm256_add_epi32(sum_high,_mm256_madd_epi16(_mm256_unpackhi_epi16(row,row_next),weight));
+                    }
+                    
+                    //unpack and pack both work per 128 bit lane, the pixels come back in order
+                    const __m256i result = _mm256_packus_epi32(_mm256_srli_epi32(sum_low,separable_output_shift),
+                                                               _mm256_srli_epi32(sum_high,separable_output_shift));
+                    const __m128i pixels = _mm_packus_epi16(_mm256_castsi256_si128(result),_mm256_extracti128_si256(result,1));
+                    
+                    _mm_storeu_si128(reinterpret_cast<__m128i*>(output_row+x),pixels);
+                }
+                return x;
+            }
+            
+            /**
+             * \brief vertical pass, 8 pixels per iteration.
+             *
+             * \return number of pixels processed.
+             */
+            PANDORA_TARGET("sse4.1")
+            inline int convolve_vertically_sse41(const uint16_t* const* rows,int width,const uint16_t* weights,
+                                                 int kernel_size,uint8_t* output_row)
+            {
+                const __m128i bias = _mm_set1_epi16(static_cast<short>(0x8000));
+                const __m128i initial_sum = _mm_set1_epi32((32768 << gaussian_kernel::fixed_point_shift) + separable_output_rounding);
+                
+                int x = 0;
+                for (; x + 8 <= width; x += 8)
+                {
+                    __m128i sum_low = initial_sum;
+                    __m128i sum_high = initial_sum;
+                    
+                    for (int k = 0; k < kernel_size; k += 2)
+                    {
+                        const int k_next = std::min(k+1,kernel_size-1);
+                        const int weight_next = (k+1 < kernel_size) ? weights[k+1] : 0;
+                        const __m128i weight = _mm_set1_epi32((weight_next << 16) | weights[k]);
+                        
+                        const __m128i row = _mm_xor_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(rows[k]+x)),bias);
+                        const __m128i row_next = _mm_xor_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(rows[k_next]+x)),bias);
+                        
+                        sum_low = _mm_add_epi32(sum_low,_mm_madd_epi16(_mm_unpacklo_epi16(row,row_next),weight));
+                        sum_high = _mm_add_epi32(sum_high,_mm_madd_epi16(_mm_unpackhi_epi16(row,row_next),weight));
+                    }
+                    
+                    const __m128i result = _mm_packus_epi32(_mm_srli_epi32(sum_low,separable_output_shift),
+                                                            _mm_srli_epi32(sum_high,separable_output_shift));
+                    
+                    _mm_storel_epi64(reinterpret_cast<__m128i*>(output_row+x),_mm_packus_epi16(result,result));
+                }
+                return x;
+            }
+#endif
+            
+            /**
+             * \brief apply the 1D Gaussian convolution on a padded row.
+             *        The sum of the u8 x Q8 products is kept as a Q8 value, without rounding.
+             *
+             * \param[in] instruction set.
+             * \param[in] padded row.
+             * \param[in] row width.
+             * \param[in] Q8 kernel weights.
+             * \param[in] kernel size.
+             * \param[in] distance between two taps : the number of interleaved channels.
+             * \param[out] smoothen row, Q8.
+             */
+            inline void convolve_horizontally(pandora::simd_level level,const uint8_t* padded_row,int width,
+                                              const uint16_t* weights,int kernel_size,int pixel_stride,uint16_t* output_row)
+            {
+                int x = 0;
+#if defined(PANDORA_X86)
+                if (level == pandora::simd_level::avx2)
+                {
+                    x = convolve_horizontally_avx2(padded_row,width,weights,kernel_size,pixel_stride,output_row);
+                }
+                else if (level == pandora::simd_level::sse41)
+                {
+                    x = convolve_horizontally_sse41(padded_row,width,weights,kernel_size,pixel_stride,output_row);
+                }
+#endif
+                //scalar path and remaining pixels of the vectorized paths
+                for (; x < width; ++x)
+                {
+                    uint32_t sum = 0;
+                    for (int k = 0; k < kernel_size; ++k)
+                    {
+                        sum += weights[k]*padded_row[x+k*pixel_stride];
+                    }
+                    output_row[x] = static_cast<uint16_t>(sum);
+                }
+            }
+            
+            /**
+             * \brief apply the 1D Gaussian convolution across a window of Q8 rows.
+             *
+             * \param[in] instruction set.
+             * \param[in] kernel_size rows centered on the row to process.
+             * \param[in] row width.
+             * \param[in] Q8 kernel weights.
+             * \param[in] kernel size.
+             * \param[out] smoothen row, rounded to the nearest value.
+             */
+            inline void convolve_vertically(pandora::simd_level level,const uint16_t* const* rows,int width,
+                                            const uint16_t* weights,int kernel_size,uint8_t* output_row)
+            {
+                int x = 0;
+#if defined(PANDORA_X86)
+                if (level == pandora::simd_level::avx2)
+                {
+                    x = convolve_vertically_avx2(rows,width,weights,kernel_size,output_row);
+                }
+                else if (level == pandora::simd_level::sse41)
+                {
+                    x = convolve_vertically_sse41(rows,width,weights,kernel_size,output_row);
+                }
+#endif
+                //scalar path and remaining pixels of the vectorized paths
+                for (; x < width; ++x)
+                {
+                    uint32_t sum = separable_output_rounding;
+                    for (int k = 0; k < kernel_size; ++k)
+                    {
+                        sum += static_cast<uint32_t>(weights[k])*rows[k][x];
+                    }
+                    output_row[x] = static_cast<uint8_t>(sum >> separable_output_shift);
+                }
+            }
+            
+            /**
+             * \brief horizontal pass of a row, see convolve_horizontally.
+             */
+            using horizontal_convolution = void (*)(pandora::simd_level,const uint8_t*,int,const uint16_t*,int,int,uint16_t*);
+            
+            /**
+             * \brief vertical pass of a row, see convolve_vertically.
+             */
+            using vertical_convolution = void (*)(pandora::simd_level,const uint16_t* const*,int,const uint16_t*,int,uint8_t*);
+            
+#if defined(PANDORA_X86)
+            /**
+             * \brief horizontal pass of a kernel size known at compile time, 32 pixels per iteration.
+             *        The taps are unrolled and the symmetric taps are folded : w x (left + right),
+             *        the sums are the same as the ones of convolve_horizontally_avx2.
+             *
+             * \return number of pixels processed.
+             */
+            template<int kernel_size>
+            PANDORA_TARGET("avx2")
+            inline int convolve_horizontally_fixed_avx2(const uint8_t* input_row,int width,const uint16_t* weights,int pixel_stride,uint16_t* output_row)
+            {
+                constexpr int kernel_radius = kernel_size/2;
+                
+                __m256i weight[kernel_radius+1];
+                for (int k = 0; k <= kernel_radius; ++k)
+                {
+                    weight[k] = _mm256_set1_epi16(static_cast<short>(weights[k]));
+                }
+                
+                int x = 0;
+                for (; x + 32 <= width; x += 32)
+                {
+                    const uint8_t* center = input_row+x+kernel_radius*pixel_stride;
+                    __m256i sum_low = _mm256_mullo_epi16(_mm256_cvtepu8_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(center))),weight[kernel_radius]);
+                    __m256i sum_high = _mm256_mullo_epi16(_mm256_cvtepu8_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(center+16))),weight[kernel_radius]);
+                    
+                    for (int k = 0; k < kernel_radius; ++k)
+                    {
+                        const uint8_t* left = input_row+x+k*pixel_stride;
+                        const uint8_t* right = input_row+x+(kernel_size-1-k)*pixel_stride;
+                        
+                        const __m256i pixels_low = _mm256_add_epi16(_mm256_cvtepu8_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(left))),
+                                                                    _mm256_cvtepu8_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(right))));
+                        const __m256i pixels_high = _mm256_add_epi16(_mm256_cvtepu8_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(left+16))),
+                                                                     _mm256_cvtepu8_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(right+16))));
+                        
+                        sum_low = _mm256_add_epi16(sum_low,_mm256_mullo_epi16(pixels_low,weight[k]));
+                        sum_high = _mm256_add_epi16(sum_high,_mm256_mullo_epi16(pixels_high,weight[k]));
+                    }
+                    
+                    _mm256_storeu_si256(reinterpret_cast<__m256i*>(output_row+x),sum_low);
+                    _mm256_storeu_si256(reinterpret_cast<__m256i*>(output_row+x+16),sum_high);
+                }
+                return x;
+            }
+            
+            /**
+             * \brief horizontal pass of a kernel size known at compile time, 16 pixels per iteration.
+             *
+             * \return number of pixels processed.
+             */
+            template<int kernel_size>
+            PANDORA_TARGET("sse4.1")
+            inline int convolve_horizontally_fixed_sse41(const uint8_t* input_row,int width,const uint16_t* weights,int pixel_stride,uint16_t* output_row)
+            {
+                constexpr int kernel_radius = kernel_size/2;
+                const __m128i zero = _mm_setzero_si128();
+                
+                __m128i weight[kernel_radius+1];
+                for (int k = 0; k <= kernel_radius; ++k)
+                {
+                    weight[k] = _mm_set1_epi16(static_cast<short>(weights[k]));
+                }
+                
+                int x = 0;
+                for (; x + 16 <= width; x += 16)
+                {
+                    const __m128i center = _mm_loadu_si128(reinterpret_cast<const __m128i*>(input_row+x+kernel_radius*pixel_stride));
+                    __m128i sum_low = _mm_mullo_epi16(_mm_cvtepu8_epi16(center),weight[kernel_radius]);
+                    __m128i sum_high = _mm_mullo_epi16(_mm_unpackhi_epi8(center,zero),weight[kernel_radius]);
+                    
+                    for (int k = 0; k < kernel_radius; ++k)
+                    {
+                        const __m128i left = _mm_loadu_si128(reinterpret_cast<const __m128i*>(input_row+x+k*pixel_stride));
+                        const __m128i right = _mm_loadu_si128(reinterpret_cast<const __m128i*>(input_row+x+(kernel_size-1-k)*pixel_stride));
+                        
+                        const __m128i pixels_low = _mm_add_epi16(_mm_cvtepu8_epi16(left),_mm_cvtepu8_epi16(right));
+                        const __m128i pixels_high = _mm_add_epi16(_mm_unpackhi_epi8(left,zero),_mm_unpackhi_epi8(right,zero));
+                        
+                        sum_low = _mm_add_epi16(sum_low,_mm_mullo_epi16(pixels_low,weight[k]));
+                        sum_high = _mm_add_epi16(sum_high,_mm_mullo_epi16(pixels_high,weight[k]));
+                    }
+                    
+                    _mm_storeu_si128(reinterpret_cast<__m128i*>(output_row+x),sum_low);
+                    _mm_storeu_si128(reinterpret_cast<__m128i*>(output_row+x+8),sum_high);
+                }
+                return x;
+            }
+            
+            /**
+             * \brief vertical pass of a kernel size known at compile time, 16 pixels per iteration.
+             *        Same biased madd scheme as convolve_vertically_avx2, with the pairs of weights and the
+             *        row pointers loaded once per row instead of once per pixel block.
+             *
+             * \return number of pixels processed.
+             */
+            template<int kernel_size>
+            PANDORA_TARGET("avx2")
+            inline int convolve_vertically_fixed_avx2(const uint16_t* const* rows,int width,const uint16_t* weights,uint8_t* output_row)
+            {
+                constexpr int pair_count = (kernel_size+1)/2;
+                const __m256i bias = _mm256_set1_epi16(static_cast<short>(0x8000));
+                const __m256i initial_sum = _mm256_set1_epi32((32768 << gaussian_kernel::fixed_point_shift) + separable_output_rounding);
+                
+                //an odd kernel ends with a pair made of the last row with a null weight
+                __m256i weight[pair_count];
+                const uint16_t* row_pairs[2*pair_count];
+                for (int k = 0; k < kernel_size; k += 2)
+                {
+                    const int weight_next = (k+1 < kernel_size) ? weights[k+1] : 0;
+                    weight[k/2] = _mm256_set1_epi32((weight_next << 16) | weights[k]);
+                    row_pairs[k] = rows[k];
+                    row_pairs[k+1] = rows[std::min(k+1,kernel_size-1)];
+                }
+                
+                int x = 0;
+                for (; x + 16 <= width; x += 16)
+                {
+                    __m256i sum_low = initial_sum;
+                    __m256i sum_high = initial_sum;
+                    
+                    for (int pair = 0; pair < pair_count; ++pair)
+                    {
+                        const __m256i row = _mm256_xor_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(row_pairs[2*pair]+x)),bias);
+                        const __m256i row_next = _mm256_xor_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(row_pairs[2*pair+1]+x)),bias);
+                        
+                        sum_low = _mm256_add_epi32(sum_low,_mm256_madd_epi16(_mm256_unpacklo_epi16(row,row_next),weight[pair]));
+                        sum_high = _mm256_add_epi32(sum_high,_mm256_madd_epi16(_mm256_unpackhi_epi16(row,row_next),weight[pair]));
+                    }
+                    
+                    const __m256i result = _mm256_packus_epi32(_mm256_srli_epi32(sum_low,separable_output_shift),
+                                                               _mm256_srli_epi32(sum_high,separable_output_shift));
+                    const __m128i pixels = _mm_packus_epi16(_mm256_castsi256_si128(result),_mm256_extracti128_si256(result,1));
+                    
+                    _mm_storeu_si128(reinterpret_cast<__m128i*>(output_row+x),pixels);
+                }
+                return x;
+            }
+            
+            /**
+             * \brief vertical pass of a kernel size known at compile time, 8 pixels per iteration.
+             *
+             * \return number of pixels processed.
+             */
+            template<int kernel_size>
+            PANDORA_TARGET("sse4.1")
+            inline int convolve_vertically_fixed_sse41(const uint16_t* const* rows,int width,const uint16_t* weights,uint8_t* output_row)
+            {
+                constexpr int pair_count = (kernel_size+1)/2;
+                const __m128i bias = _mm_set1_epi16(static_cast<short>(0x8000));
+                const __m128i initial_sum = _mm_set1_epi32((32768 << gaussian_kernel::fixed_point_shift) + separable_output_rounding);
+                
+                __m128i weight[pair_count];
+                const uint16_t* row_pairs[2*pair_count];
+                for (int k = 0; k < kernel_size; k += 2)
+                {
+                    const int weight_next = (k+1 < kernel_size) ? weights[k+1] : 0;
+                    weight[k/2] = _mm_set1_epi32((weight_next << 16) | weights[k]);
+                    row_pairs[k] = rows[k];
+                    row_pairs[k+1] = rows[std::min(k+1,kernel_size-1)];
+                }
+                
+                int x = 0;
+                for (; x + 8 <= width; x += 8)
+                {
+                    __m128i sum_low = initial_sum;
+                    __m128i sum_high = initial_sum;
+                    
+                    for (int pair = 0; pair < pair_count; ++pair)
+                    {
+                        const __m128i row = _mm_xor_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(row_pairs[2*pair]+x)),bias);
+                        const __m128i row_next = _mm_xor_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(row_pairs[2*pair+1]+x)),bias);
+                        
+                        sum_low = _mm_add_epi32(sum_low,_mm_madd_epi16(_mm_unpacklo_epi16(row,row_next),weight[pair]));
+                        sum_high = _mm_add_epi32(sum_high,_mm_madd_epi16(_mm_unpackhi_epi16(row,row_next),weight[pair]));
+                    }
+                    
+                    const __m128i result = _mm_packus_epi32(_mm_srli_epi32(sum_low,separable_output_shift),
+                                                            _mm_srli_epi32(sum_high,separable_output_shift));
+                    
+                    _mm_storel_epi64(reinterpret_cast<__m128i*>(output_row+x),_mm_packus_epi16(result,result));
+                }
+                return x;
+            }
+#endif
+            
+            /**
+             * \brief convolve_horizontally for a kernel size known at compile time.
+             *        Same output, with unrolled and folded taps.
+             */
+            template<int kernel_size>
+            inline void convolve_horizontally_fixed(pandora::simd_level level,const uint8_t* padded_row,int width,
+                                                    const uint16_t* weights,int /*kernel_size*/,int pixel_stride,uint16_t* output_row)
+            {
+                constexpr int kernel_radius = kernel_size/2;
+                
+                int x = 0;
+#if defined(PANDORA_X86)
+                if (level == pandora::simd_level::avx2)
+                {
+                    x = convolve_horizontally_fixed_avx2<kernel_size>(padded_row,width,weights,pixel_stride,output_row);
+                }
+                else if (level == pandora::simd_level::sse41)
+                {
+                    x = convolve_horizontally_fixed_sse41<kernel_size>(padded_row,width,weights,pixel_stride,output_row);
+                }
+#endif
+                for (; x < width; ++x)
+                {
+                    uint32_t sum = weights[kernel_radius]*padded_row[x+kernel_radius*pixel_stride];
+                    for (int k = 0; k < kernel_radius; ++k)
+                    {
+                        sum += weights[k]*(padded_row[x+k*pixel_stride]+padded_row[x+(kernel_size-1-k)*pixel_stride]);
+                    }
+                    output_row[x] = static_cast<uint16_t>(sum);
+                }
+            }
+            
+            /**
+             * \brief convolve_vertically for a kernel size known at compile time.
+             *        Same output, with unrolled and folded taps.
+             */
+            template<int kernel_size>
+            inline void convolve_vertically_fixed(pandora::simd_level level,const uint16_t* const* rows,int width,
+                                                  const uint16_t* weights,int /*kernel_size*/,uint8_t* output_row)
+            {
+                constexpr int kernel_radius = kernel_size/2;
+                
+                int x = 0;
+#if defined(PANDORA_X86)
+                if (level == pandora::simd_level::avx2)
+                {
+                    x = convolve_vertically_fixed_avx2<kernel_size>(rows,width,weights,output_row);
+                }
+                else if (level == pandora::simd_level::sse41)
+                {
+                    x = convolve_vertically_fixed_sse41<kernel_size>(rows,width,weights,output_row);
+                }
+#endif
+                for (; x < width; ++x)
+                {
+                    uint32_t sum = separable_output_rounding + static_cast<uint32_t>(weights[kernel_radius])*rows[kernel_radius][x];
+                    for (int k = 0; k < kernel_radius; ++k)
+                    {
+                        sum += static_cast<uint32_t>(weights[k])*(rows[k][x]+rows[kernel_size-1-k][x]);
+                    }
+                    output_row[x] = static_cast<uint8_t>(sum >> separable_output_shift);
+                }
+            }
+            
+            /**
+             * \brief horizontal pass specialized for a kernel size, for symmetric kernels.
+             *
+             * \param[in] kernel size.
+             * \return convolve_horizontally_fixed for the usual kernel sizes (3, 5 and 7), nullptr otherwise.
+             */
+            inline horizontal_convolution fixed_horizontal_convolution(int kernel_size)
+            {
+                switch (kernel_size)
+                {
+                    case 3:
+                        return &convolve_horizontally_fixed<3>;
+                    case 5:
+                        return &convolve_horizontally_fixed<5>;
+                    case 7:
+                        return &convolve_horizontally_fixed<7>;
+                    default:
+                        return nullptr;
+                }
+            }
+            
+            /**
+             * \brief vertical pass specialized for a kernel size, for symmetric kernels.
+             *
+             * \param[in] kernel size.
+             * \return convolve_vertically_fixed for the usual kernel sizes (3, 5 and 7), nullptr otherwise.
+             */
+            inline vertical_convolution fixed_vertical_convolution(int kernel_size)
+            {
+                switch (kernel_size)
+                {
+                    case 3:
+                        return &convolve_vertically_fixed<3>;
+                    case 5:
+                        return &convolve_vertically_fixed<5>;
+                    case 7:
+                        return &convolve_vertically_fixed<7>;
+                    default:
+                        return nullptr;
+                }
+            }
+        }
+    }
+}
+
+#endif //__PANDORA_FILTER_SEPARABLE_CONVOLUTION_H__
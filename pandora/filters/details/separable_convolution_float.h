@@ -0,0 +1,350 @@
+/*BSD 3-Clause License
+
+Copyright (c) 2018, eelcoder
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+* Redistributions of source code must retain the above copyright notice, this
+list of conditions and the following disclaimer.
+
+* Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentation
+and/or other materials provided with the distribution.
+
+* Neither the name of the copyright holder nor the names of its
+contributors may be used to endorse or promote products derived from
+this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+         SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+#ifndef __PANDORA_FILTER_SEPARABLE_CONVOLUTION_FLOAT_H__
+#define __PANDORA_FILTER_SEPARABLE_CONVOLUTION_FLOAT_H__
+
+#include <pandora/cpu_features.h>
+#include <pandora/filters/details/pixel_traits.h>
+#include <cstdint>
+#include <cstring>
+
+namespace pandora
+{
+    namespace filter
+    {
+        namespace details
+        {
+            /**
+             * Row convolutions of the separable filter for the 16 bit and floating point pixels, and of the
+             * gaussian derivatives for any pixel (their horizontal pass reads 8 bit pixels as well).
+             * The intermediate rows and the weights are floats, every path computes the same
+             * sequence of products and additions, so the vectorized paths match the scalar one exactly.
+             */
+            
+#if defined(PANDORA_X86)
+            PANDORA_TARGET("avx2")
+            inline __m256 load_float_avx2(const float* pixels)
+            {
+                return _mm256_loadu_ps(pixels);
+            }
+            
+            PANDORA_TARGET("avx2")
+            inline __m256 load_float_avx2(const uint16_t* pixels)
+            {
+                return _mm256_cvtepi32_ps(_mm256_cvtepu16_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(pixels))));
+            }
+            
+            PANDORA_TARGET("avx2")
+            inline __m256 load_float_avx2(const uint8_t* pixels)
+            {
+                return _mm256_cvtepi32_ps(_mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(pixels))));
+            }
+            
+            PANDORA_TARGET("avx2")
+            inline void store_float_avx2(float* pixels,__m256 values)
+            {
+                _mm256_storeu_ps(pixels,values);
+            }
+            
+            /**
+             * \brief round and saturate 8 values to u16, same operations as pixel_traits<uint16_t>::from_float.
+             */
+            PANDORA_TARGET("avx2")
+            inline void store_float_avx2(uint16_t* pixels,__m256 values)
+            {
+                const __m256 rounded = _mm256_min_ps(_mm256_set1_ps(65535.f),_mm256_add_ps(values,_mm256_set1_ps(0.5f)));
+                const __m256i integers = _mm256_cvttps_epi32(_mm256_max_ps(_mm256_setzero_ps(),rounded));
+                
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(pixels),
+                                 _mm_packus_epi32(_mm256_castsi256_si128(integers),_mm256_extracti128_si256(integers,1)));
+            }
+            
+            /**
+             * \brief round and saturate 8 values to u8, same operations as pixel_traits<uint8_t>::from_float.
+             */
+            PANDORA_TARGET("avx2")
+            inline void store_float_avx2(uint8_t* pixels,__m256 values)
+            {
+                const __m256 rounded = _mm256_min_ps(_mm256_set1_ps(255.f),_mm256_add_ps(values,_mm256_set1_ps(0.5f)));
+                const __m256i integers = _mm256_cvttps_epi32(_mm256_max_ps(_mm256_setzero_ps(),rounded));
+                const __m128i words = _mm_packus_epi32(_mm256_castsi256_si128(integers),_mm256_extracti128_si256(integers,1));
+                
+                _mm_storel_epi64(reinterpret_cast<__m128i*>(pixels),_mm_packus_epi16(words,words));
+            }
+            
+            PANDORA_TARGET("sse4.1")
+            inline __m128 load_float_sse41(const float* pixels)
+            {
+                return _mm_loadu_ps(pixels);
+            }
+            
+            PANDORA_TARGET("sse4.1")
+            inline __m128 load_float_sse41(const uint16_t* pixels)
+            {
+                return _mm_cvtepi32_ps(_mm_cvtepu16_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(pixels))));
+            }
+            
+            PANDORA_TARGET("sse4.1")
+            inline __m128 load_float_sse41(const uint8_t* pixels)
+            {
+                int packed_pixels;
+                std::memcpy(&packed_pixels,pixels,sizeof(packed_pixels));
+                return _mm_cvtepi32_ps(_mm_cvtepu8_epi32(_mm_cvtsi32_si128(packed_pixels)));
+            }
+            
+            PANDORA_TARGET("sse4.1")
+            inline void store_float_sse41(float* pixels,__m128 values)
+            {
+                _mm_storeu_ps(pixels,values);
+            }
+            
+            PANDORA_TARGET("sse4.1")
+            inline void store_float_sse41(uint16_t* pixels,__m128 values)
+            {
+                const __m128 rounded = _mm_min_ps(_mm_set1_ps(65535.f),_mm_add_ps(values,_mm_set1_ps(0.5f)));
+                const __m128i integers = _mm_cvttps_epi32(_mm_max_ps(_mm_setzero_ps(),rounded));
+                
+                _mm_storel_epi64(reinterpret_cast<__m128i*>(pixels),_mm_packus_epi32(integers,integers));
+            }
+            
+            PANDORA_TARGET("sse4.1")
+            inline void store_float_sse41(uint8_t* pixels,__m128 values)
+            {
+                const __m128 rounded = _mm_min_ps(_mm_set1_ps(255.f),_mm_add_ps(values,_mm_set1_ps(0.5f)));
+                const __m128i integers = _mm_cvttps_epi32(_mm_max_ps(_mm_setzero_ps(),rounded));
+                const __m128i words = _mm_packus_epi32(integers,integers);
+                
+                const int packed_pixels = _mm_cvtsi128_si32(_mm_packus_epi16(words,words));
+                std::memcpy(pixels,&packed_pixels,sizeof(packed_pixels));
+            }
+            
+            /**
+             * \brief horizontal pass, 16 pixels per iteration.
+             *
+             * \return number of pixels processed.
+             */
+            template<typename pixel_type>
+            PANDORA_TARGET("avx2")
+            inline int convolve_horizontally_float_avx2(const pixel_type* input_row,int width,const float* weights,
+                                                        int kernel_size,int pixel_stride,float* output_row)
+            {
+                int x = 0;
+                for (; x + 16 <= width; x += 16)
+                {
+                    __m256 sum_low = _mm256_setzero_ps();
+                    __m256 sum_high = _mm256_setzero_ps();
+                    
+                    for (int k = 0; k < kernel_size; ++k)
+                    {
+                        const __m256 weight = _mm256_set1_ps(weights[k]);
+                        const pixel_type* tap = input_row+x+k*pixel_stride;
+                        
+                        sum_low = _mm256_add_ps(sum_low,_mm256_mul_ps(weight,load_float_avx2(tap)));
+                        sum_high = _mm256_add_ps(sum_high,_mm256_mul_ps(weight,load_float_avx2(tap+8)));
+                    }
+                    
+                    _mm256_storeu_ps(output_row+x,sum_low);
+                    _mm256_storeu_ps(output_row+x+8,sum_high);
+                }
+                return x;
+            }
+            
+            /**
+             * \brief horizontal pass, 8 pixels per iteration.
+             *
+             * \return number of pixels processed.
+             */
+            template<typename pixel_type>
+            PANDORA_TARGET("sse4.1")
+            inline int convolve_horizontally_float_sse41(const pixel_type* input_row,int width,const float* weights,
+                                                         int kernel_size,int pixel_stride,float* output_row)
+            {
+                int x = 0;
+                for (; x + 8 <= width; x += 8)
+                {
+                    __m128 sum_low = _mm_setzero_ps();
+                    __m128 sum_high = _mm_setzero_ps();
+                    
+                    for (int k = 0; k < kernel_size; ++k)
+                    {
+                        const __m128 weight = _mm_set1_ps(weights[k]);
+                        const pixel_type* tap = input_row+x+k*pixel_stride;
+                        
+                        sum_low = _mm_add_ps(sum_low,_mm_mul_ps(weight,load_float_sse41(tap)));
+                        sum_high = _mm_add_ps(sum_high,_mm_mul_ps(weight,load_float_sse41(tap+4)));
+                    }
+                    
+                    _mm_storeu_ps(output_row+x,sum_low);
+                    _mm_storeu_ps(output_row+x+4,sum_high);
+                }
+                return x;
+            }
+            
+            /**
+             * \brief vertical pass, 16 pixels per iteration.
+             *
+             * \return number of pixels processed.
+             */
+            template<typename pixel_type>
+            PANDORA_TARGET("avx2")
+            inline int convolve_vertically_float_avx2(const float* const* rows,int width,const float* weights,
+                                                      int kernel_size,pixel_type* output_row)
+            {
+                int x = 0;
+                for (; x + 16 <= width; x += 16)
+                {
+                    __m256 sum_low = _mm256_setzero_ps();
+                    __m256 sum_high = _mm256_setzero_ps();
+                    
+                    for (int k = 0; k < kernel_size; ++k)
+                    {
+                        const __m256 weight = _mm256_set1_ps(weights[k]);
+                        
+                        sum_low = _mm256_add_ps(sum_low,_mm256_mul_ps(weight,_mm256_loadu_ps(rows[k]+x)));
+                        sum_high = _mm256_add_ps(sum_high,_mm256_mul_ps(weight,_mm256_loadu_ps(rows[k]+x+8)));
+                    }
+                    
+                    store_float_avx2(output_row+x,sum_low);
+                    store_float_avx2(output_row+x+8,sum_high);
+                }
+                return x;
+            }
+            
+            /**
+             * \brief vertical pass, 8 pixels per iteration.
+             *
+             * \return number of pixels processed.
+             */
+            template<typename pixel_type>
+            PANDORA_TARGET("sse4.1")
+            inline int convolve_vertically_float_sse41(const float* const* rows,int width,const float* weights,
+                                                       int kernel_size,pixel_type* output_row)
+            {
+                int x = 0;
+                for (; x + 8 <= width; x += 8)
+                {
+                    __m128 sum_low = _mm_setzero_ps();
+                    __m128 sum_high = _mm_setzero_ps();
+                    
+                    for (int k = 0; k < kernel_size; ++k)
+                    {
+                        const __m128 weight = _mm_set1_ps(weights[k]);
+                        
+                        sum_low = _mm_add_ps(sum_low,_mm_mul_ps(weight,_mm_loadu_ps(rows[k]+x)));
+                        sum_high = _mm_add_ps(sum_high,_mm_mul_ps(weight,_mm_loadu_ps(rows[k]+x+4)));
+                    }
+                    
+                    store_float_sse41(output_row+x,sum_low);
+                    store_float_sse41(output_row+x+4,sum_high);
+                }
+                return x;
+            }
+#endif
+            
+            /**
+             * \brief apply the 1D Gaussian convolution on a padded row of 16 bit or floating point pixels.
+             *
+             * \param[in] instruction set.
+             * \param[in] padded row.
+             * \param[in] row width.
+             * \param[in] kernel weights.
+             * \param[in] kernel size.
+             * \param[in] distance between two taps : the number of interleaved channels.
+             * \param[out] smoothen row.
+             */
+            template<typename pixel_type>
+            inline void convolve_horizontally_float(pandora::simd_level level,const pixel_type* padded_row,int width,
+                                                    const float* weights,int kernel_size,int pixel_stride,float* output_row)
+            {
+                int x = 0;
+#if defined(PANDORA_X86)
+                if (level == pandora::simd_level::avx2)
+                {
+                    x = convolve_horizontally_float_avx2(padded_row,width,weights,kernel_size,pixel_stride,output_row);
+                }
+                else if (level == pandora::simd_level::sse41)
+                {
+                    x = convolve_horizontally_float_sse41(padded_row,width,weights,kernel_size,pixel_stride,output_row);
+                }
+#endif
+                //scalar path and remaining pixels of the vectorized paths
+                for (; x < width; ++x)
+                {
+                    float sum = 0.f;
+                    for (int k = 0; k < kernel_size; ++k)
+                    {
+                        sum += weights[k]*static_cast<float>(padded_row[x+k*pixel_stride]);
+                    }
+                    output_row[x] = sum;
+                }
+            }
+            
+            /**
+             * \brief apply the 1D Gaussian convolution across a window of float rows.
+             *
+             * \param[in] instruction set.
+             * \param[in] kernel_size rows centered on the row to process.
+             * \param[in] row width.
+             * \param[in] kernel weights.
+             * \param[in] kernel size.
+             * \param[out] smoothen row, rounded and saturated for the 16 bit pixels.
+             */
+            template<typename pixel_type>
+            inline void convolve_vertically_float(pandora::simd_level level,const float* const* rows,int width,
+                                                  const float* weights,int kernel_size,pixel_type* output_row)
+            {
+                int x = 0;
+#if defined(PANDORA_X86)
+                if (level == pandora::simd_level::avx2)
+                {
+                    x = convolve_vertically_float_avx2(rows,width,weights,kernel_size,output_row);
+                }
+                else if (level == pandora::simd_level::sse41)
+                {
+                    x = convolve_vertically_float_sse41(rows,width,weights,kernel_size,output_row);
+                }
+#endif
+                //scalar path and remaining pixels of the vectorized paths
+                for (; x < width; ++x)
+                {
+                    float sum = 0.f;
+                    for (int k = 0; k < kernel_size; ++k)
+                    {
+                        sum += weights[k]*rows[k][x];
+                    }
+                    output_row[x] = pixel_traits<pixel_type>::from_float(sum);
+                }
+            }
+        }
+    }
+}
+
+#endif //__PANDORA_FILTER_SEPARABLE_CONVOLUTION_FLOAT_H__
@@ -0,0 +1,147 @@
+/*BSD 3-Clause License
+
+Copyright (c) 2018, eelcoder
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+* Redistributions of source code must retain the above copyright notice, this
+list of conditions and the following disclaimer.
+
+* Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentation
+and/or other materials provided with the distribution.
+
+* Neither the name of the copyright holder nor the names of its
+contributors may be used to endorse or promote products derived from
+this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+         SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+#ifndef __PANDORA_FILTER_SHARPEN_ROW_H__
+#define __PANDORA_FILTER_SHARPEN_ROW_H__
+
+#include <pandora/cpu_features.h>
+#include <pandora/filters/details/pixel_traits.h>
+#include <pandora/filters/details/separable_convolution_float.h>
+#include <cmath>
+
+namespace pandora
+{
+    namespace filter
+    {
+        namespace details
+        {
+            /**
+             * Row operation of the unsharp mask : output = input + amount x (input - blurred), for the pixels
+             * whose difference with the blurred pixel is at least the threshold, the input otherwise.
+             * Every path computes the same float operations, rounded and saturated like pixel_traits,
+             * so the vectorized paths match the scalar one exactly.
+             */
+            
+#if defined(PANDORA_X86)
+            /**
+             * \brief sharpen 8 pixels per iteration.
+             *
+             * \return number of pixels processed.
+             */
+            template<typename pixel_type>
+            PANDORA_TARGET("avx2")
+            int sharpen_row_avx2(const pixel_type* input_row,const pixel_type* blurred_row,int width,
+                                 float amount,float threshold,pixel_type* output_row)
+            {
+                const __m256 amount_vector = _mm256_set1_ps(amount);
+                const __m256 threshold_vector = _mm256_set1_ps(threshold);
+                const __m256 sign_mask = _mm256_set1_ps(-0.f);
+                
+                int x = 0;
+                for (; x + 8 <= width; x += 8)
+                {
+                    const __m256 value = load_float_avx2(input_row+x);
+                    const __m256 difference = _mm256_sub_ps(value,load_float_avx2(blurred_row+x));
+                    const __m256 sharpened = _mm256_add_ps(value,_mm256_mul_ps(amount_vector,difference));
+                    const __m256 above_threshold = _mm256_cmp_ps(_mm256_andnot_ps(sign_mask,difference),threshold_vector,_CMP_GE_OQ);
+                    
+                    store_float_avx2(output_row+x,_mm256_blendv_ps(value,sharpened,above_threshold));
+                }
+                return x;
+            }
+            
+            /**
+             * \brief sharpen 4 pixels per iteration.
+             *
+             * \return number of pixels processed.
+             */
+            template<typename pixel_type>
+            PANDORA_TARGET("sse4.1")
+            int sharpen_row_sse41(const pixel_type* input_row,const pixel_type* blurred_row,int width,
+                                  float amount,float threshold,pixel_type* output_row)
+            {
+                const __m128 amount_vector = _mm_set1_ps(amount);
+                const __m128 threshold_vector = _mm_set1_ps(threshold);
+                const __m128 sign_mask = _mm_set1_ps(-0.f);
+                
+                int x = 0;
+                for (; x + 4 <= width; x += 4)
+                {
+                    const __m128 value = load_float_sse41(input_row+x);
+                    const __m128 difference = _mm_sub_ps(value,load_float_sse41(blurred_row+x));
+                    const __m128 sharpened = _mm_add_ps(value,_mm_mul_ps(amount_vector,difference));
+                    const __m128 above_threshold = _mm_cmpge_ps(_mm_andnot_ps(sign_mask,difference),threshold_vector);
+                    
+                    store_float_sse41(output_row+x,_mm_blendv_ps(value,sharpened,above_threshold));
+                }
+                return x;
+            }
+#endif
+            
+            /**
+             * \brief sharpen a row with its blurred row.
+             *
+             * \param[in] instruction set.
+             * \param[in] input row.
+             * \param[in] blurred row.
+             * \param[in] row width.
+             * \param[in] amount of sharpening.
+             * \param[in] smallest difference sharpened.
+             * \param[out] output row, rounded and saturated for the integer pixels.
+             */
+            template<typename pixel_type>
+            inline void sharpen_row(pandora::simd_level level,const pixel_type* input_row,const pixel_type* blurred_row,int width,
+                                    float amount,float threshold,pixel_type* output_row)
+            {
+                int x = 0;
+#if defined(PANDORA_X86)
+                if (level == pandora::simd_level::avx2)
+                {
+                    x = sharpen_row_avx2(input_row,blurred_row,width,amount,threshold,output_row);
+                }
+                else if (level == pandora::simd_level::sse41)
+                {
+                    x = sharpen_row_sse41(input_row,blurred_row,width,amount,threshold,output_row);
+                }
+#endif
+                //scalar path and remaining pixels of the vectorized paths
+                for (; x < width; ++x)
+                {
+                    const float value = static_cast<float>(input_row[x]);
+                    const float difference = value - static_cast<float>(blurred_row[x]);
+                    const float sharpened = std::abs(difference) >= threshold ? value + amount*difference : value;
+                    output_row[x] = pixel_traits<pixel_type>::from_float(sharpened);
+                }
+            }
+        }
+    }
+}
+
+#endif //__PANDORA_FILTER_SHARPEN_ROW_H__
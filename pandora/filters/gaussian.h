@@ -33,22 +33,83 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #define __PANDORA_FILTER_GAUSSIAN_H__
 
 #include <pandora/image.h>
+#include <pandora/region.h>
+#include <pandora/thread_pool.h>
 #include <pandora/filters/details/gaussian_naive.h>
 #include <pandora/filters/details/gaussian_separable.h>
+#include <pandora/filters/details/gaussian_simd.h>
+#include <pandora/filters/details/gaussian_fixed.h>
+#include <pandora/filters/details/gaussian_recursive.h>
+#include <pandora/filters/details/gaussian_box.h>
+#include <pandora/filters/details/gaussian_fft.h>
+#include <algorithm>
+#include <atomic>
+#include <type_traits>
+#include <utility>
+#include <vector>
 
 namespace pandora
 {
 	namespace filter
 	{
+        namespace details
+        {
+            /**
+             * \brief true if the implementation can filter a band of rows : apply(input,output,y_begin,y_end).
+             */
+            template<typename impl,typename = void>
+            struct has_band_apply : std::false_type
+            {
+            };
+            
+            template<typename impl>
+            struct has_band_apply<impl,decltype(std::declval<impl&>().apply(std::declval<const typename impl::image_type&>(),
+                                                                            std::declval<typename impl::image_type&>(),0,0))> : std::true_type
+            {
+            };
+            
+            /**
+             * \brief true if the implementation filters interleaved channels : apply_interleaved(input,output,channel_count).
+             */
+            template<typename impl,typename = void>
+            struct has_interleaved_apply : std::false_type
+            {
+            };
+            
+            template<typename impl>
+            struct has_interleaved_apply<impl,decltype(std::declval<impl&>().apply_interleaved(std::declval<const typename impl::image_type&>(),
+                                                                                              std::declval<typename impl::image_type&>(),0))> : std::true_type
+            {
+            };
+            
+            /**
+             * \brief true if the implementation can filter a region : apply(input,output,region).
+             */
+            template<typename impl,typename = void>
+            struct has_region_apply : std::false_type
+            {
+            };
+            
+            template<typename impl>
+            struct has_region_apply<impl,decltype(std::declval<impl&>().apply(std::declval<const typename impl::image_type&>(),
+                                                                              std::declval<typename impl::image_type&>(),
+                                                                              std::declval<const pandora::region&>()))> : std::true_type
+            {
+            };
+        }
+        
         /**
          * \brief generic interface of the gaussian filter.
-         * \tparam gaussian filter implementation.
+         * \tparam gaussian filter implementation, its image_type gives the pixel type.
          */
         template<typename impl>
         class gaussian : impl
         {
          public:
             
+            using image_type = typename impl::image_type;
+            using image_pair = std::pair<const image_type*,image_type*>;
+            
            /**
             * \brief constructor.
             *
@@ -74,19 +135,331 @@ namespace pandora
             }
             
             /**
-             * \brief constructor.
+             * \brief constructor of an anisotropic filter, for the separable implementations.
+             *
+             * \param[in] image width.
+             * \param[in] image height.
+             * \param[in] horizontal kernel size.
+             * \param[in] horizontal kernel sigma.
+             * \param[in] vertical kernel size.
+             * \param[in] vertical kernel sigma.
+             */
+            gaussian(int width,int height,int kernel_size_x,float sigma_x,int kernel_size_y,float sigma_y):
+                impl(width,height,kernel_size_x,sigma_x,kernel_size_y,sigma_y)
+            {
+            }
+            
+            /**
+             * \brief apply the filter on all the channels (spectrum) of an image.
              *
              * \param[in] input image.
              * \param[out] output image.
              */
-            void operator()(const pandora::image8u &input_image, pandora::image8u &output_image)
+            void operator()(const image_type &input_image, image_type &output_image)
             {
                 impl::apply(input_image,output_image);
             }
+            
+            /**
+             * \brief apply the filter on horizontal bands of the image, in parallel.
+             *        Each band is processed by its own copy of the implementation, reading the
+             *        kernel_radius rows around the band, so the output is identical to the single threaded one.
+             *        The implementations without a band decomposition (recursive, box, fft) run on the calling thread.
+             *
+             * \param[in] input image.
+             * \param[out] output image.
+             * \param[in] thread pool running the bands.
+             */
+            void operator()(const image_type &input_image, image_type &output_image, pandora::thread_pool &pool)
+            {
+                apply_bands(input_image,output_image,pool,details::has_band_apply<impl>());
+            }
+            
+            /**
+             * \brief apply the filter on regions of interest of an image, the pixels outside of them are left untouched.
+             *        The regions are clipped to the image and the overlapping ones are first turned into disjoint
+             *        regions (see pandora::disjoint_regions), so the pixels they share are filtered once.
+             *        The pixels around a region are read from the image, so the output is identical to the
+             *        filtered image. The implementations without a region pass (recursive, box, fft) filter the
+             *        whole image and copy the regions.
+             *
+             * \param[in] input image.
+             * \param[out] output image, of the size of the input image.
+             * \param[in] regions of interest, possibly overlapping.
+             */
+            void operator()(const image_type &input_image, image_type &output_image, const std::vector<pandora::region> &regions)
+            {
+                const auto areas = pandora::disjoint_regions(regions,pandora::region{0,0,input_image.width(),input_image.height()});
+                apply_regions(input_image,output_image,areas,details::has_region_apply<impl>());
+            }
+            
+            /**
+             * \brief apply the filter on regions of interest of an image, in parallel.
+             *        Each thread filters whole disjoint regions with its own copy of the implementation, and takes
+             *        the next region when it is done.
+             *
+             * \param[in] input image.
+             * \param[out] output image, of the size of the input image.
+             * \param[in] regions of interest, possibly overlapping.
+             * \param[in] thread pool running the regions.
+             */
+            void operator()(const image_type &input_image, image_type &output_image, const std::vector<pandora::region> &regions,
+                            pandora::thread_pool &pool)
+            {
+                const auto areas = pandora::disjoint_regions(regions,pandora::region{0,0,input_image.width(),input_image.height()});
+                apply_regions(input_image,output_image,areas,pool,details::has_region_apply<impl>());
+            }
+            
+            /**
+             * \brief apply the filter on a batch of images, possibly of different sizes, on the calling thread.
+             *        The scratch buffers of the implementation are kept from one image to the next.
+             *
+             * \param[in] input and output images.
+             * \param[in] number of images.
+             */
+            void batch(const image_pair* images, int image_count)
+            {
+                for (int i = 0; i < image_count; ++i)
+                {
+                    impl::apply(*images[i].first,*images[i].second);
+                }
+            }
+            
+            /**
+             * \brief apply the filter on a batch of images, possibly of different sizes, in parallel.
+             *        Each thread filters whole images with its own copy of the implementation, whose scratch
+             *        buffers are kept between the images and the batches, and takes the next image of the
+             *        batch when it is done, so the images of different sizes balance the load.
+             *
+             * \param[in] input and output images.
+             * \param[in] number of images.
+             * \param[in] thread pool running the images.
+             */
+            void batch(const image_pair* images, int image_count, pandora::thread_pool &pool)
+            {
+                const int worker_count = std::max(1,std::min(pool.size(),image_count));
+                reserve_workers(worker_count);
+                
+                std::atomic<int> next_image{0};
+                pool.parallel_for(worker_count,[&](int worker)
+                {
+                    for (int i = next_image++; i < image_count; i = next_image++)
+                    {
+                        worker_impls[worker].apply(*images[i].first,*images[i].second);
+                    }
+                });
+            }
+            
+            /**
+             * \brief apply the filter on an image of interleaved channels (r g b r g b ...) : each row holds
+             *        width x channel_count values. A buffer is filtered in place of a copy by wrapping it :
+             *        image_type(buffer,width*channel_count,height,1,1,true).
+             *        The separable implementations filter the channels together, the others filter a planar copy.
+             *
+             * \param[in] input image, width x channel_count values per row.
+             * \param[out] output image.
+             * \param[in] number of interleaved channels.
+             */
+            void interleaved(const image_type &input_image, image_type &output_image, int channel_count)
+            {
+                apply_interleaved(input_image,output_image,channel_count,details::has_interleaved_apply<impl>());
+            }
+            
+         private:
+            
+            /**
+             * \brief apply the filter on horizontal bands of the image, in parallel.
+             */
+            void apply_bands(const image_type &input_image, image_type &output_image, pandora::thread_pool &pool, std::true_type)
+            {
+                const int height = input_image.height();
+                const int band_count = std::max(1,std::min(pool.size(),height / minimum_band_height));
+                
+                reserve_workers(band_count);
+                
+                pool.parallel_for(band_count,[&](int band)
+                {
+                    const int y_begin = height * band / band_count;
+                    const int y_end = height * (band + 1) / band_count;
+                    worker_impls[band].apply(input_image,output_image,y_begin,y_end);
+                });
+            }
+            
+            /**
+             * \brief no band decomposition, apply the filter on the calling thread.
+             */
+            void apply_bands(const image_type &input_image, image_type &output_image, pandora::thread_pool &, std::false_type)
+            {
+                impl::apply(input_image,output_image);
+            }
+            
+            /**
+             * \brief filter the disjoint regions one after the other.
+             */
+            void apply_regions(const image_type &input_image, image_type &output_image, const std::vector<pandora::region> &areas,
+                               std::true_type)
+            {
+                for (const auto& area : areas)
+                {
+                    impl::apply(input_image,output_image,area);
+                }
+            }
+            
+            /**
+             * \brief no region pass, filter the whole image and copy the regions.
+             */
+            void apply_regions(const image_type &input_image, image_type &output_image, const std::vector<pandora::region> &areas,
+                               std::false_type)
+            {
+                if (areas.empty())
+                {
+                    return;
+                }
+                
+                region_output.assign(input_image.width(),input_image.height(),1,input_image.spectrum());
+                impl::apply(input_image,region_output);
+                for (const auto& area : areas)
+                {
+                    for (int c = 0; c < input_image.spectrum(); ++c)
+                    {
+                        for (int y = area.y; y < area.y + area.height; ++y)
+                        {
+                            const auto* filtered_row = region_output.data(area.x,y,0,c);
+                            std::copy(filtered_row,filtered_row+area.width,output_image.data(area.x,y,0,c));
+                        }
+                    }
+                }
+            }
+            
+            /**
+             * \brief filter the disjoint regions in parallel.
+             */
+            void apply_regions(const image_type &input_image, image_type &output_image, const std::vector<pandora::region> &areas,
+                               pandora::thread_pool &pool, std::true_type)
+            {
+                const int area_count = static_cast<int>(areas.size());
+                const int worker_count = std::max(1,std::min(pool.size(),area_count));
+                reserve_workers(worker_count);
+                
+                std::atomic<int> next_area{0};
+                pool.parallel_for(worker_count,[&](int worker)
+                {
+                    for (int i = next_area++; i < area_count; i = next_area++)
+                    {
+                        worker_impls[worker].apply(input_image,output_image,areas[i]);
+                    }
+                });
+            }
+            
+            /**
+             * \brief no region pass, filter the whole image on the calling thread and copy the regions.
+             */
+            void apply_regions(const image_type &input_image, image_type &output_image, const std::vector<pandora::region> &areas,
+                               pandora::thread_pool &, std::false_type)
+            {
+                apply_regions(input_image,output_image,areas,std::false_type());
+            }
+            
+            /**
+             * \brief copies of the implementation, one per band, per region or per thread of a batch.
+             *
+             * \param[in] number of copies.
+             */
+            void reserve_workers(int worker_count)
+            {
+                if (worker_impls.size() < static_cast<std::size_t>(worker_count))
+                {
+                    worker_impls.resize(worker_count,static_cast<const impl&>(*this));
+                }
+            }
+            
+            /**
+             * \brief filter the interleaved channels together.
+             */
+            void apply_interleaved(const image_type &input_image, image_type &output_image, int channel_count, std::true_type)
+            {
+                impl::apply_interleaved(input_image,output_image,channel_count);
+            }
+            
+            /**
+             * \brief filter a planar copy of the interleaved channels.
+             */
+            void apply_interleaved(const image_type &input_image, image_type &output_image, int channel_count, std::false_type)
+            {
+                const int width = input_image.width()/channel_count;
+                const int height = input_image.height();
+                
+                planar_input.assign(width,height,1,channel_count);
+                planar_output.assign(width,height,1,channel_count);
+                for (int y = 0; y < height; ++y)
+                {
+                    const auto* input_row = input_image.data(0,y);
+                    for (int x = 0; x < width; ++x)
+                    {
+                        for (int c = 0; c < channel_count; ++c)
+                        {
+                            planar_input(x,y,0,c) = input_row[x*channel_count+c];
+                        }
+                    }
+                }
+                
+                impl::apply(planar_input,planar_output);
+                
+                for (int y = 0; y < height; ++y)
+                {
+                    auto* output_row = output_image.data(0,y);
+                    for (int x = 0; x < width; ++x)
+                    {
+                        for (int c = 0; c < channel_count; ++c)
+                        {
+                            output_row[x*channel_count+c] = planar_output(x,y,0,c);
+                        }
+                    }
+                }
+            }
+            
+            //below this height, the halo and the scheduling cost more than what the band brings
+            static constexpr int minimum_band_height = 32;
+            
+            std::vector<impl> worker_impls;
+            image_type planar_input;
+            image_type planar_output;
+            image_type region_output;
         };
 	}
-    using gaussian_naive_filter = filter::gaussian<filter::details::gaussian_naive_impl>;
-    using gaussian_separable_filter = filter::gaussian<filter::details::gaussian_separable_impl>;
+    //filters of any pixel type : uint8_t, uint16_t or float
+    template<typename pixel_type,typename border = filter::border_clamp>
+    using basic_gaussian_naive_filter = filter::gaussian<filter::details::gaussian_naive_impl<pixel_type,border>>;
+    template<typename pixel_type,typename border = filter::border_clamp>
+    using basic_gaussian_separable_filter = filter::gaussian<filter::details::gaussian_separable_impl<pixel_type,border>>;
+    template<typename pixel_type,typename border = filter::border_clamp>
+    using basic_gaussian_simd_filter = filter::gaussian<filter::details::gaussian_simd_impl<pixel_type,border>>;
+    template<typename pixel_type,int kernel_size>
+    using basic_gaussian_fixed_filter = filter::gaussian<filter::details::gaussian_fixed_impl<kernel_size,pixel_type>>;
+    template<typename pixel_type>
+    using basic_gaussian_recursive_filter = filter::gaussian<filter::details::gaussian_recursive_impl<pixel_type>>;
+    template<typename pixel_type,typename border = filter::border_clamp>
+    using basic_gaussian_fft_filter = filter::gaussian<filter::details::gaussian_fft_impl<pixel_type,border>>;
+    template<typename pixel_type,int pass_count = 3>
+    using basic_gaussian_box_filter = filter::gaussian<filter::details::gaussian_box_impl<pass_count,pixel_type>>;
+    
+    using gaussian_naive_filter = basic_gaussian_naive_filter<uint8_t>;
+    using gaussian_separable_filter = basic_gaussian_separable_filter<uint8_t>;
+    using gaussian_simd_filter = basic_gaussian_simd_filter<uint8_t>;
+    template<int kernel_size>
+    using gaussian_fixed_filter = basic_gaussian_fixed_filter<uint8_t,kernel_size>;
+    template<typename border>
+    using gaussian_naive_border_filter = basic_gaussian_naive_filter<uint8_t,border>;
+    template<typename border>
+    using gaussian_separable_border_filter = basic_gaussian_separable_filter<uint8_t,border>;
+    template<typename border>
+    using gaussian_simd_border_filter = basic_gaussian_simd_filter<uint8_t,border>;
+    using gaussian_recursive_filter = basic_gaussian_recursive_filter<uint8_t>;
+    using gaussian_fft_filter = basic_gaussian_fft_filter<uint8_t>;
+    template<typename border>
+    using gaussian_fft_border_filter = basic_gaussian_fft_filter<uint8_t,border>;
+    template<int pass_count = 3>
+    using gaussian_box_filter = basic_gaussian_box_filter<uint8_t,pass_count>;
 }
 
 #endif //__PANDORA_FILTER_GAUSSIAN_H__
@@ -0,0 +1,295 @@
+/*BSD 3-Clause License
+
+Copyright (c) 2018, eelcoder
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+* Redistributions of source code must retain the above copyright notice, this
+list of conditions and the following disclaimer.
+
+* Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentation
+and/or other materials provided with the distribution.
+
+* Neither the name of the copyright holder nor the names of its
+contributors may be used to endorse or promote products derived from
+this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+         SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+#ifndef __PANDORA_FILTER_GAUSSIAN_DERIVATIVES_H__
+#define __PANDORA_FILTER_GAUSSIAN_DERIVATIVES_H__
+
+#include <pandora/image.h>
+#include <pandora/cpu_features.h>
+#include <pandora/filters/border.h>
+#include <pandora/filters/details/gaussian_derivative_kernel.h>
+#include <pandora/filters/details/separable_convolution.h>
+#include <pandora/filters/details/separable_convolution_float.h>
+#include <algorithm>
+#include <vector>
+
+namespace pandora
+{
+    namespace filter
+    {
+        /**
+         * \brief Gaussian derivatives of an image : Gx, Gy, Gxx, Gyy and Gxy, computed in a single traversal.
+         *        Each input row is padded once and filtered horizontally by the kernels of order 0, 1 and 2 (the
+         *        ones needed by the requested outputs) into three ring buffers, like the separable filter. Each
+         *        output row is then the vertical convolution of one of the rings, so the derivatives sharing a
+         *        horizontal order share its rows : Gy and Gyy the smoothed rows, Gx and Gxy the first derivative rows.
+         *        The input is read once whatever the number of outputs, and the intermediate rows stay in the cache.
+         *        The derivatives are signed floats, the row convolutions are the float ones of the separable
+         *        filter, so every instruction set gives the same output.
+         *
+         * \tparam pixel type of the input image : uint8_t, uint16_t or float.
+         * \tparam border policy.
+         */
+        template<typename pixel_type = uint8_t,typename border = border_clamp>
+        class gaussian_derivatives
+        {
+         public:
+            
+            using image_type = pandora::image<pixel_type>;
+            
+            /**
+             * \brief output images, of the size of the input image, nullptr for the derivatives not needed.
+             */
+            struct derivative_images
+            {
+                pandora::image32f* dx = nullptr;
+                pandora::image32f* dy = nullptr;
+                pandora::image32f* dxx = nullptr;
+                pandora::image32f* dyy = nullptr;
+                pandora::image32f* dxy = nullptr;
+            };
+            
+            /**
+             * \brief constructor.
+             *
+             * \param[in] kernel size.
+             * \param[in] kernel sigma.
+             * \param[in] instruction set to use, limited to the ones supported by the cpu.
+             */
+            gaussian_derivatives(int kernel_size,float sigma,pandora::simd_level requested_level = pandora::cpu_simd_level()):
+                kernels{{kernel_size,sigma,0},{kernel_size,sigma,1},{kernel_size,sigma,2}},
+                level(std::min(requested_level,pandora::cpu_simd_level())),
+                window(kernels[0].size())
+            {
+            }
+            
+            /**
+             * \brief compute the requested derivatives of all the channels of an image.
+             *
+             * \param[in] input image.
+             * \param[out] derivative images, allocated by the caller.
+             */
+            void apply(const image_type &input_image,const derivative_images &outputs)
+            {
+                const int width = input_image.width();
+                const int height = input_image.height();
+                
+                //horizontal orders read by the requested outputs
+                needed_orders[0] = outputs.dy || outputs.dyy;
+                needed_orders[1] = outputs.dx || outputs.dxy;
+                needed_orders[2] = outputs.dxx != nullptr;
+                
+                const int tile_width = tile_columns(width);
+                reserve(tile_width);
+                
+                for (int c = 0; c < input_image.spectrum(); ++c)
+                {
+                    for (int x_begin = 0; x_begin < width; x_begin += tile_width)
+                    {
+                        apply_tile(input_image.data(0,0,0,c),outputs,width,height,c,x_begin,std::min(width,x_begin+tile_width));
+                    }
+                }
+            }
+            
+         private:
+            
+            /**
+             * \brief compute the derivatives on a tile of columns of an image plane.
+             *
+             * \param[in] input plane.
+             * \param[out] derivative images.
+             * \param[in] plane width.
+             * \param[in] plane height.
+             * \param[in] channel.
+             * \param[in] first column of the tile.
+             * \param[in] column following the tile.
+             */
+            void apply_tile(const pixel_type* input,const derivative_images &outputs,int width,int height,int c,int x_begin,int x_end)
+            {
+                const int kernel_radius = kernels[0].radius();
+                
+                int previous_source = -1;
+                for (int y = -kernel_radius; y < kernel_radius; ++y)
+                {
+                    filter_virtual_row(input,width,height,x_begin,x_end,y,previous_source);
+                }
+                
+                for (int y = 0; y < height; ++y)
+                {
+                    filter_virtual_row(input,width,height,x_begin,x_end,y+kernel_radius,previous_source);
+                    
+                    //output : horizontal order, vertical order
+                    filter_row_vertically(outputs.dx,1,0,c,x_begin,x_end,y);
+                    filter_row_vertically(outputs.dy,0,1,c,x_begin,x_end,y);
+                    filter_row_vertically(outputs.dxx,2,0,c,x_begin,x_end,y);
+                    filter_row_vertically(outputs.dyy,0,2,c,x_begin,x_end,y);
+                    filter_row_vertically(outputs.dxy,1,1,c,x_begin,x_end,y);
+                }
+            }
+            
+            /**
+             * \brief apply the horizontal kernels of the needed orders on the columns of a virtual row,
+             *        read through the border policy. The row is padded once for all the orders.
+             *
+             * \param[in] input plane.
+             * \param[in] plane width.
+             * \param[in] plane height.
+             * \param[in] first column.
+             * \param[in] column following the last one.
+             * \param[in] virtual row index.
+             * \param[in,out] input row of the previous virtual row, -1 if none.
+             */
+            void filter_virtual_row(const pixel_type* input,int width,int height,int x_begin,int x_end,int y,int &previous_source)
+            {
+                const int source = border::index(y,height);
+                const int row_size = x_end-x_begin;
+                
+                if (source >= 0 && source != previous_source)
+                {
+                    details::pad_row<border>(input+static_cast<std::size_t>(source)*width,width,x_begin,x_end,kernels[0].radius(),padded_row.data());
+                }
+                
+                for (int order = 0; order < order_count; ++order)
+                {
+                    if (!needed_orders[order])
+                    {
+                        continue;
+                    }
+                    
+                    float* row = ring_row(order,y);
+                    if (source < 0)
+                    {
+                        //constant border : the derivatives of a constant row are 0
+                        std::fill(row,row+row_size,order == 0 ? static_cast<float>(details::border_value<pixel_type,border>()) : 0.f);
+                    }
+                    else if (source == previous_source)
+                    {
+                        std::copy(ring_row(order,y-1),ring_row(order,y-1)+row_size,row);
+                    }
+                    else
+                    {
+                        details::convolve_horizontally_float(level,padded_row.data(),row_size,kernels[order].data(),kernels[order].size(),1,row);
+                    }
+                }
+                previous_source = source;
+            }
+            
+            /**
+             * \brief apply the vertical kernel of an order on the rows of a ring, centered on a row.
+             *
+             * \param[out] derivative image, nothing is done if nullptr.
+             * \param[in] horizontal order : ring to read.
+             * \param[in] vertical order.
+             * \param[in] channel.
+             * \param[in] first column.
+             * \param[in] column following the last one.
+             * \param[in] row to process.
+             */
+            void filter_row_vertically(pandora::image32f* output,int horizontal_order,int vertical_order,int c,int x_begin,int x_end,int y)
+            {
+                if (!output)
+                {
+                    return;
+                }
+                
+                const int kernel_radius = kernels[0].radius();
+                for (int k = -kernel_radius; k <= kernel_radius; ++k)
+                {
+                    window[k+kernel_radius] = ring_row(horizontal_order,y+k);
+                }
+                
+                const auto& kernel = kernels[vertical_order];
+                details::convolve_vertically_float(level,window.data(),x_end-x_begin,kernel.data(),kernel.size(),output->data(x_begin,y,0,c));
+            }
+            
+            /**
+             * \brief make room for tiles of width columns, the buffers only grow.
+             *
+             * \param[in] tile width.
+             */
+            void reserve(int width)
+            {
+                const std::size_t padded_size = static_cast<std::size_t>(width+2*kernels[0].radius());
+                if (padded_row.size() < padded_size)
+                {
+                    padded_row.resize(padded_size);
+                }
+                if (ring_image.width() < width)
+                {
+                    ring_image.assign(width,kernels[0].size(),1,order_count,0);
+                }
+            }
+            
+            /**
+             * \brief width of the column tiles : the whole row when the rings of the needed orders fit in
+             *        ring_cache_bytes, otherwise the largest multiple of 64 columns that fits.
+             *
+             * \param[in] image width.
+             * \return tile width.
+             */
+            int tile_columns(int width) const
+            {
+                const int ring_count = static_cast<int>(std::count(needed_orders,needed_orders+order_count,true));
+                const int ring_column_bytes = std::max(1,ring_count)*kernels[0].size()*static_cast<int>(sizeof(float));
+                if (width*ring_column_bytes <= ring_cache_bytes)
+                {
+                    return width;
+                }
+                return std::max(64,(ring_cache_bytes/ring_column_bytes) & ~63);
+            }
+            
+            /**
+             * \brief row of a ring buffer holding a horizontally filtered virtual row.
+             *
+             * \param[in] horizontal order.
+             * \param[in] virtual row index, from -kernel_size.
+             * \return row of the ring buffer.
+             */
+            float* ring_row(int order,int y)
+            {
+                return ring_image.data(0,(y + kernels[0].size()) % kernels[0].size(),0,order);
+            }
+            
+            static constexpr int order_count = 3;
+            
+            //same budget as the ring buffer of the separable filter
+            static constexpr int ring_cache_bytes = 128*1024;
+            
+            details::gaussian_derivative_kernel kernels[order_count];
+            pandora::simd_level level;
+            bool needed_orders[order_count] = {false,false,false};
+            std::vector<pixel_type> padded_row;
+            pandora::image<float> ring_image;
+            std::vector<const float*> window;
+        };
+    }
+}
+
+#endif //__PANDORA_FILTER_GAUSSIAN_DERIVATIVES_H__
@@ -0,0 +1,285 @@
+/*BSD 3-Clause License
+
+Copyright (c) 2018, eelcoder
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+* Redistributions of source code must retain the above copyright notice, this
+list of conditions and the following disclaimer.
+
+* Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentation
+and/or other materials provided with the distribution.
+
+* Neither the name of the copyright holder nor the names of its
+contributors may be used to endorse or promote products derived from
+this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+         SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+#ifndef __PANDORA_FILTER_GAUSSIAN_INCREMENTAL_H__
+#define __PANDORA_FILTER_GAUSSIAN_INCREMENTAL_H__
+
+#include <pandora/image.h>
+#include <pandora/region.h>
+#include <pandora/filters/border.h>
+#include <pandora/filters/details/gaussian_simd.h>
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+namespace pandora
+{
+    namespace filter
+    {
+        /**
+         * \brief incremental gaussian filter, for images of which only small regions change from one call to the next
+         *        (interactive drawing, annotations). The first call filters the whole image, the next ones are given
+         *        the dirty regions of the input and only filter again the output pixels they reach : the dirty
+         *        regions dilated by the kernel radius (and the pixels reading them through the border policy).
+         *        The output and the horizontally filtered image (with kernel_radius virtual rows above and below)
+         *        are kept between the calls, the output is identical to gaussian_simd_filter.
+         *
+         * \tparam pixel type : uint8_t, uint16_t or float.
+         * \tparam border policy.
+         */
+        template<typename pixel_type = uint8_t,typename border = border_clamp>
+        class gaussian_incremental
+        {
+            using engine_type = details::gaussian_simd_impl<pixel_type,border>;
+            using intermediate_type = typename engine_type::intermediate_type;
+            
+         public:
+            
+            using image_type = pandora::image<pixel_type>;
+            
+            /**
+             * \brief constructor.
+             *
+             * \param[in] kernel size.
+             * \param[in] kernel sigma.
+             */
+            gaussian_incremental(int kernel_size,float sigma):
+                engine(0,0,kernel_size,sigma),window(engine.get_vertical_kernel().size())
+            {
+            }
+            
+            /**
+             * \brief filter a whole image and keep it as the base of the next updates.
+             *
+             * \param[in] input image.
+             * \return filtered image, valid until the next call.
+             */
+            const image_type& apply(const image_type &input_image)
+            {
+                const int width = input_image.width();
+                const int height = input_image.height();
+                const int kernel_radius = engine.get_vertical_kernel().radius();
+                
+                engine.reserve(width);
+                horizontal_image.assign(width,height+2*kernel_radius,1,input_image.spectrum());
+                output_image.assign(width,height,1,input_image.spectrum());
+                
+                const pandora::region whole_image{0,0,width,height};
+                filter_horizontally(input_image,whole_image);
+                filter_vertically(whole_image);
+                return output_image;
+            }
+            
+            /**
+             * \brief filter again the output pixels reached by the dirty regions of the input image.
+             *        The input image is the whole image, the same one as the previous call outside of the dirty regions.
+             *        When nothing was filtered yet or when the image size changes, the whole image is filtered.
+             *
+             * \param[in] input image.
+             * \param[in] regions of the input image changed since the previous call, possibly overlapping.
+             * \return filtered image, valid until the next call.
+             */
+            const image_type& update(const image_type &input_image,const std::vector<pandora::region> &dirty_regions)
+            {
+                if (!output_image.is_sameXYZC(input_image))
+                {
+                    return apply(input_image);
+                }
+                
+                const int width = input_image.width();
+                const int height = input_image.height();
+                const pandora::region whole_image{0,0,width,height};
+                
+                //the dirty rows are filtered again on the columns they reach, the output on the columns and the rows
+                std::vector<pandora::region> horizontal_regions;
+                std::vector<pandora::region> output_regions;
+                for (const auto& dirty : pandora::disjoint_regions(dirty_regions,whole_image))
+                {
+                    const auto columns = reached_range(dirty.x,dirty.x+dirty.width,width,engine.get_horizontal_kernel().radius());
+                    const auto rows = reached_range(dirty.y,dirty.y+dirty.height,height,engine.get_vertical_kernel().radius());
+                    horizontal_regions.push_back({columns.first,dirty.y,columns.second-columns.first,dirty.height});
+                    output_regions.push_back({columns.first,rows.first,columns.second-columns.first,rows.second-rows.first});
+                }
+                
+                for (const auto& area : pandora::disjoint_regions(horizontal_regions,whole_image))
+                {
+                    filter_horizontally(input_image,area);
+                }
+                for (const auto& area : pandora::disjoint_regions(output_regions,whole_image))
+                {
+                    filter_vertically(area);
+                }
+                return output_image;
+            }
+            
+            /**
+             * \brief filtered image of the last call.
+             */
+            const image_type& output() const
+            {
+                return output_image;
+            }
+            
+         private:
+            
+            /**
+             * \brief apply the horizontal pass on a region of the input image, and set the virtual rows
+             *        outside of the image that read its rows through the border policy.
+             *
+             * \param[in] input image.
+             * \param[in] region to filter.
+             */
+            void filter_horizontally(const image_type &input_image,const pandora::region &area)
+            {
+                const int width = input_image.width();
+                const int height = input_image.height();
+                const int kernel_radius = engine.get_vertical_kernel().radius();
+                
+                for (int c = 0; c < input_image.spectrum(); ++c)
+                {
+                    for (int y = area.y; y < area.y + area.height; ++y)
+                    {
+                        engine.convolve_row_horizontally(input_image.data(0,y,0,c),width,area.x,area.x+area.width,intermediate_row(y,c)+area.x);
+                    }
+                    
+                    for (int y = -kernel_radius; y < 0; ++y)
+                    {
+                        filter_virtual_row(y,height,c,area);
+                    }
+                    for (int y = height; y < height + kernel_radius; ++y)
+                    {
+                        filter_virtual_row(y,height,c,area);
+                    }
+                }
+            }
+            
+            /**
+             * \brief set the columns of a region in a virtual row outside of the image, if it reads a row of the region.
+             *
+             * \param[in] virtual row index.
+             * \param[in] image height.
+             * \param[in] channel.
+             * \param[in] region filtered horizontally.
+             */
+            void filter_virtual_row(int y,int height,int c,const pandora::region &area)
+            {
+                intermediate_type* virtual_row = intermediate_row(y,c) + area.x;
+                const int source = border::index(y,height);
+                if (source < 0)
+                {
+                    std::fill(virtual_row,virtual_row+area.width,engine_type::filtered_border_value());
+                }
+                else if (source >= area.y && source < area.y + area.height)
+                {
+                    const intermediate_type* source_row = intermediate_row(source,c) + area.x;
+                    std::copy(source_row,source_row+area.width,virtual_row);
+                }
+            }
+            
+            /**
+             * \brief apply the vertical pass on a region of the output image.
+             *
+             * \param[in] region to filter.
+             */
+            void filter_vertically(const pandora::region &area)
+            {
+                const int kernel_radius = engine.get_vertical_kernel().radius();
+                
+                for (int c = 0; c < output_image.spectrum(); ++c)
+                {
+                    for (int y = area.y; y < area.y + area.height; ++y)
+                    {
+                        for (int k = -kernel_radius; k <= kernel_radius; ++k)
+                        {
+                            window[k+kernel_radius] = intermediate_row(y+k,c) + area.x;
+                        }
+                        engine.convolve_rows_vertically(window.data(),area.width,output_image.data(area.x,y,0,c));
+                    }
+                }
+            }
+            
+            /**
+             * \brief range of the outputs of an axis whose kernel reads a range of inputs : the range dilated
+             *        by the kernel radius, and the outputs near the image borders reading it through the border policy
+             *        (the opposite border for border_wrap).
+             *
+             * \param[in] first input.
+             * \param[in] input following the last one.
+             * \param[in] size of the axis.
+             * \param[in] kernel radius of the axis.
+             * \return first output and output following the last one.
+             */
+            static std::pair<int,int> reached_range(int begin,int end,int size,int kernel_radius)
+            {
+                int first = std::max(0,begin-kernel_radius);
+                int last = std::min(size,end+kernel_radius);
+                
+                for (int i = -kernel_radius; i < 0; ++i)
+                {
+                    const int source = border::index(i,size);
+                    if (source >= begin && source < end)
+                    {
+                        first = 0;
+                        last = std::max(last,std::min(size,i+kernel_radius+1));
+                    }
+                }
+                for (int i = size; i < size + kernel_radius; ++i)
+                {
+                    const int source = border::index(i,size);
+                    if (source >= begin && source < end)
+                    {
+                        first = std::min(first,std::max(0,i-kernel_radius));
+                        last = size;
+                    }
+                }
+                return std::make_pair(first,last);
+            }
+            
+            /**
+             * \brief horizontally filtered row.
+             *
+             * \param[in] virtual row index, from -kernel_radius to height + kernel_radius.
+             * \param[in] channel.
+             * \return row of the horizontally filtered image.
+             */
+            intermediate_type* intermediate_row(int y,int c)
+            {
+                return horizontal_image.data(0,y+engine.get_vertical_kernel().radius(),0,c);
+            }
+            
+            engine_type engine;
+            pandora::image<intermediate_type> horizontal_image;
+            image_type output_image;
+            std::vector<const intermediate_type*> window;
+        };
+    }
+}
+
+#endif //__PANDORA_FILTER_GAUSSIAN_INCREMENTAL_H__
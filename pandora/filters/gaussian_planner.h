@@ -0,0 +1,434 @@
+/*BSD 3-Clause License
+
+Copyright (c) 2018, eelcoder
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+* Redistributions of source code must retain the above copyright notice, this
+list of conditions and the following disclaimer.
+
+* Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentation
+and/or other materials provided with the distribution.
+
+* Neither the name of the copyright holder nor the names of its
+contributors may be used to endorse or promote products derived from
+this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+         SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+#ifndef __PANDORA_FILTER_GAUSSIAN_PLANNER_H__
+#define __PANDORA_FILTER_GAUSSIAN_PLANNER_H__
+
+#include <pandora/image.h>
+#include <pandora/thread_pool.h>
+#include <pandora/filters/gaussian.h>
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <string>
+#include <tuple>
+#include <vector>
+
+namespace pandora
+{
+    namespace filter
+    {
+        /**
+         * \brief gaussian filter implementations selectable at runtime.
+         */
+        enum class gaussian_engine
+        {
+            separable,
+            simd,
+            recursive,
+            box,
+            fft
+        };
+        
+        namespace details
+        {
+            /**
+             * \brief type erased gaussian filter.
+             */
+            class gaussian_engine_base
+            {
+             public:
+                virtual ~gaussian_engine_base() = default;
+                
+                /**
+                 * \brief apply the filter, on the thread pool when there is one.
+                 *
+                 * \param[in] input image.
+                 * \param[out] output image.
+                 * \param[in] thread pool, may be null.
+                 */
+                virtual void apply(const pandora::image8u &input_image, pandora::image8u &output_image, pandora::thread_pool* pool) = 0;
+            };
+            
+            /**
+             * \brief type erased filter::gaussian<impl>.
+             */
+            template<typename filter_type>
+            class gaussian_engine_model : public gaussian_engine_base
+            {
+             public:
+                gaussian_engine_model(int width,int height,int kernel_size,float sigma):
+                    filter(width,height,kernel_size,sigma)
+                {
+                }
+                
+                void apply(const pandora::image8u &input_image, pandora::image8u &output_image, pandora::thread_pool* pool) override
+                {
+                    if (pool != nullptr)
+                    {
+                        filter(input_image,output_image,*pool);
+                    }
+                    else
+                    {
+                        filter(input_image,output_image);
+                    }
+                }
+                
+             private:
+                filter_type filter;
+            };
+            
+            /**
+             * \brief create a gaussian filter implementation.
+             *
+             * \param[in] implementation.
+             * \param[in] image width.
+             * \param[in] image height.
+             * \param[in] kernel size.
+             * \param[in] kernel sigma.
+             * \return type erased filter.
+             */
+            inline std::unique_ptr<gaussian_engine_base> make_gaussian_engine(gaussian_engine engine,int width,int height,int kernel_size,float sigma)
+            {
+                switch (engine)
+                {
+                    case gaussian_engine::simd:
+                        return std::unique_ptr<gaussian_engine_base>(new gaussian_engine_model<pandora::gaussian_simd_filter>(width,height,kernel_size,sigma));
+                    case gaussian_engine::recursive:
+                        return std::unique_ptr<gaussian_engine_base>(new gaussian_engine_model<pandora::gaussian_recursive_filter>(width,height,kernel_size,sigma));
+                    case gaussian_engine::box:
+                        return std::unique_ptr<gaussian_engine_base>(new gaussian_engine_model<pandora::gaussian_box_filter<3>>(width,height,kernel_size,sigma));
+                    case gaussian_engine::fft:
+                        return std::unique_ptr<gaussian_engine_base>(new gaussian_engine_model<pandora::gaussian_fft_filter>(width,height,kernel_size,sigma));
+                    case gaussian_engine::separable:
+                    default:
+                        return std::unique_ptr<gaussian_engine_base>(new gaussian_engine_model<pandora::gaussian_separable_filter>(width,height,kernel_size,sigma));
+                }
+            }
+            
+            /**
+             * \brief name of an implementation, as written in the wisdom files.
+             */
+            inline const char* gaussian_engine_name(gaussian_engine engine)
+            {
+                static const char* names[] = {"separable","simd","recursive","box","fft"};
+                return names[static_cast<int>(engine)];
+            }
+        }
+        
+        /**
+         * \brief picks the fastest gaussian filter implementation for a frame geometry (FFTW style).
+         *        The first request for a (width, height, kernel size, sigma, threads) benchmarks the
+         *        candidates on a noise frame and remembers the winner, the following ones are lookups.
+         *        The plans can be saved to and loaded from a wisdom file.
+         *
+         *        By default only the exact implementations are candidates (separable and simd, which
+         *        produce the same output); the recursive, box and fft filters, whose output differs, can be allowed.
+         *        The planner is thread safe.
+         */
+        class gaussian_planner
+        {
+         public:
+            
+            /**
+             * \brief constructor.
+             *
+             * \param[in] also consider the recursive, box and fft filters, whose output differs from the exact filters.
+             */
+            explicit gaussian_planner(bool allow_approximations = false):
+                allow_approximations(allow_approximations)
+            {
+            }
+            
+            /**
+             * \brief fastest implementation for a frame geometry, benchmarked on the first request.
+             *
+             * \param[in] image width.
+             * \param[in] image height.
+             * \param[in] kernel size.
+             * \param[in] kernel sigma.
+             * \param[in] thread pool the filter will run on, may be null.
+             * \return implementation to use.
+             */
+            gaussian_engine plan(int width,int height,int kernel_size,float sigma,pandora::thread_pool* pool = nullptr)
+            {
+                const plan_key key{width,height,kernel_size,sigma,(pool != nullptr) ? pool->size() : 1,allow_approximations};
+                
+                {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    auto plan = wisdom.find(key);
+                    if (plan != wisdom.end())
+                    {
+                        return plan->second;
+                    }
+                }
+                
+                //benchmark outside of the lock, two threads may plan the same geometry : both find the same answer
+                const gaussian_engine engine = measure(width,height,kernel_size,sigma,pool);
+                
+                std::lock_guard<std::mutex> lock(mutex);
+                wisdom.emplace(key,engine);
+                return engine;
+            }
+            
+            /**
+             * \brief number of plans known.
+             */
+            std::size_t size() const
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                return wisdom.size();
+            }
+            
+            /**
+             * \brief write the plans to a wisdom file.
+             *
+             * \param[in] file path.
+             * \return false if the file cannot be written.
+             */
+            bool save_wisdom(const std::string &path) const
+            {
+                std::ofstream file(path);
+                if (!file)
+                {
+                    return false;
+                }
+                
+                //enough digits for the sigma to read back exactly
+                file.precision(9);
+                
+                std::lock_guard<std::mutex> lock(mutex);
+                for (const auto& plan : wisdom)
+                {
+                    const plan_key &key = plan.first;
+                    file << key.width << ' ' << key.height << ' ' << key.kernel_size << ' ' << key.sigma << ' '
+                         << key.threads << ' ' << key.approximations << ' ' << details::gaussian_engine_name(plan.second) << '\n';
+                }
+                return static_cast<bool>(file);
+            }
+            
+            /**
+             * \brief read the plans of a wisdom file, they replace the known plans of the same geometry.
+             *
+             * \param[in] file path.
+             * \return false if the file cannot be read or is malformed.
+             */
+            bool load_wisdom(const std::string &path)
+            {
+                std::ifstream file(path);
+                if (!file)
+                {
+                    return false;
+                }
+                
+                std::map<plan_key,gaussian_engine> loaded;
+                plan_key key;
+                std::string name;
+                while (file >> key.width >> key.height >> key.kernel_size >> key.sigma >> key.threads >> key.approximations >> name)
+                {
+                    bool known = false;
+                    for (auto engine : {gaussian_engine::separable,gaussian_engine::simd,gaussian_engine::recursive,gaussian_engine::box,gaussian_engine::fft})
+                    {
+                        if (name == details::gaussian_engine_name(engine))
+                        {
+                            loaded[key] = engine;
+                            known = true;
+                        }
+                    }
+                    if (!known)
+                    {
+                        return false;
+                    }
+                }
+                if (!file.eof())
+                {
+                    return false;
+                }
+                
+                std::lock_guard<std::mutex> lock(mutex);
+                for (const auto& plan : loaded)
+                {
+                    wisdom[plan.first] = plan.second;
+                }
+                return true;
+            }
+            
+         private:
+            
+            struct plan_key
+            {
+                int width;
+                int height;
+                int kernel_size;
+                float sigma;
+                int threads;
+                bool approximations;
+                
+                bool operator<(const plan_key &other) const
+                {
+                    return std::tie(width,height,kernel_size,sigma,threads,approximations) <
+                           std::tie(other.width,other.height,other.kernel_size,other.sigma,other.threads,other.approximations);
+                }
+            };
+            
+            /**
+             * \brief benchmark the candidates on a noise frame.
+             *
+             * \return fastest implementation.
+             */
+            gaussian_engine measure(int width,int height,int kernel_size,float sigma,pandora::thread_pool* pool) const
+            {
+                pandora::image8u input_image(width,height,1,1,0);
+                pandora::image8u output_image(width,height,1,1,0);
+                
+                std::default_random_engine generator;
+                std::uniform_int_distribution<int> dist(0,255);
+                for (auto& pixel_value : input_image)
+                {
+                    pixel_value = static_cast<pandora::image8u::value_type>(dist(generator));
+                }
+                
+                std::vector<gaussian_engine> candidates = {gaussian_engine::separable,gaussian_engine::simd};
+                if (allow_approximations)
+                {
+                    candidates.push_back(gaussian_engine::recursive);
+                    candidates.push_back(gaussian_engine::box);
+                    candidates.push_back(gaussian_engine::fft);
+                }
+                
+                gaussian_engine best_engine = candidates.front();
+                double best_time = 0;
+                
+                for (auto candidate : candidates)
+                {
+                    auto engine = details::make_gaussian_engine(candidate,width,height,kernel_size,sigma);
+                    
+                    //warm up, then keep the best of a few runs
+                    engine->apply(input_image,output_image,pool);
+                    
+                    double candidate_time = 0;
+                    for (int run = 0; run < measured_runs; ++run)
+                    {
+                        const auto start = std::chrono::steady_clock::now();
+                        engine->apply(input_image,output_image,pool);
+                        const double time = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+                        candidate_time = (run == 0) ? time : std::min(candidate_time,time);
+                    }
+                    
+                    if (candidate == candidates.front() || candidate_time < best_time)
+                    {
+                        best_engine = candidate;
+                        best_time = candidate_time;
+                    }
+                }
+                return best_engine;
+            }
+            
+            static constexpr int measured_runs = 3;
+            
+            bool allow_approximations;
+            mutable std::mutex mutex;
+            std::map<plan_key,gaussian_engine> wisdom;
+        };
+        
+        /**
+         * \brief gaussian filter whose implementation is chosen at runtime by a planner.
+         */
+        class gaussian_auto
+        {
+         public:
+            
+            /**
+             * \brief constructor, plans the implementation if it is not known yet.
+             *
+             * \param[in] planner.
+             * \param[in] image width.
+             * \param[in] image height.
+             * \param[in] kernel size.
+             * \param[in] kernel sigma.
+             * \param[in] thread pool running the filter, may be null.
+             */
+            gaussian_auto(gaussian_planner &planner,int width,int height,int kernel_size,float sigma,pandora::thread_pool* pool = nullptr):
+                selected_engine(planner.plan(width,height,kernel_size,sigma,pool)),
+                engine(details::make_gaussian_engine(selected_engine,width,height,kernel_size,sigma)),
+                pool(pool)
+            {
+            }
+            
+            /**
+             * \brief constructor, uses the given implementation.
+             *
+             * \param[in] implementation.
+             * \param[in] image width.
+             * \param[in] image height.
+             * \param[in] kernel size.
+             * \param[in] kernel sigma.
+             * \param[in] thread pool running the filter, may be null.
+             */
+            gaussian_auto(gaussian_engine selected_engine,int width,int height,int kernel_size,float sigma,pandora::thread_pool* pool = nullptr):
+                selected_engine(selected_engine),
+                engine(details::make_gaussian_engine(selected_engine,width,height,kernel_size,sigma)),
+                pool(pool)
+            {
+            }
+            
+            /**
+             * \brief apply the filter.
+             *
+             * \param[in] input image.
+             * \param[out] output image.
+             */
+            void operator()(const pandora::image8u &input_image, pandora::image8u &output_image)
+            {
+                engine->apply(input_image,output_image,pool);
+            }
+            
+            /**
+             * \brief implementation in use.
+             */
+            gaussian_engine implementation() const
+            {
+                return selected_engine;
+            }
+            
+         private:
+            gaussian_engine selected_engine;
+            std::unique_ptr<details::gaussian_engine_base> engine;
+            pandora::thread_pool* pool;
+        };
+    }
+    using gaussian_auto_filter = filter::gaussian_auto;
+}
+
+#endif //__PANDORA_FILTER_GAUSSIAN_PLANNER_H__
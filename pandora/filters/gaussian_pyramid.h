@@ -0,0 +1,211 @@
+/*BSD 3-Clause License
+
+Copyright (c) 2018, eelcoder
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+* Redistributions of source code must retain the above copyright notice, this
+list of conditions and the following disclaimer.
+
+* Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentation
+and/or other materials provided with the distribution.
+
+* Neither the name of the copyright holder nor the names of its
+contributors may be used to endorse or promote products derived from
+this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+         SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+#ifndef __PANDORA_FILTER_GAUSSIAN_PYRAMID_H__
+#define __PANDORA_FILTER_GAUSSIAN_PYRAMID_H__
+
+#include <pandora/image.h>
+#include <pandora/thread_pool.h>
+#include <pandora/filters/border.h>
+#include <pandora/filters/details/gaussian_decimation.h>
+#include <algorithm>
+#include <vector>
+
+namespace pandora
+{
+    namespace filter
+    {
+        /**
+         * \brief Gaussian image pyramid : level 0 is the input image, each next level is the previous one
+         *        filtered and decimated by 2, (width+1)/2 x (height+1)/2.
+         *        The filter and the decimation are fused (see details::gaussian_decimation_impl), so only the
+         *        pixels kept by the next level are filtered. All the levels live in one arena, allocated on the
+         *        first build and reused by the next builds of the same size (or smaller).
+         *        For 8 bit pixels each level is bit exact with the even pixels of the previous one filtered by
+         *        gaussian_simd_filter.
+         *
+         * \tparam pixel type : uint8_t, uint16_t or float.
+         * \tparam border policy.
+         */
+        template<typename pixel_type = uint8_t,typename border = border_clamp>
+        class gaussian_pyramid
+        {
+         public:
+            
+            using image_type = pandora::image<pixel_type>;
+            
+            /**
+             * \brief constructor.
+             *
+             * \param[in] number of levels, the input image included.
+             * \param[in] kernel size.
+             * \param[in] kernel sigma.
+             */
+            gaussian_pyramid(int level_count,int kernel_size,float sigma):
+                level_count(std::max(1,level_count)),
+                decimation(kernel_size,sigma)
+            {
+                levels.reserve(this->level_count);
+            }
+            
+            //the levels are views of the arena
+            gaussian_pyramid(const gaussian_pyramid&) = delete;
+            gaussian_pyramid& operator=(const gaussian_pyramid&) = delete;
+            
+            /**
+             * \brief build the levels of an image.
+             *
+             * \param[in] input image.
+             */
+            void build(const image_type &input_image)
+            {
+                allocate(input_image);
+                for (int i = 1; i < level_count; ++i)
+                {
+                    const image_type &previous = levels[i-1];
+                    for (int c = 0; c < previous.spectrum(); ++c)
+                    {
+                        decimation.apply(previous.data(0,0,0,c),previous.width(),previous.height(),levels[i].data(0,0,0,c),0,levels[i].height());
+                    }
+                }
+            }
+            
+            /**
+             * \brief build the levels of an image, each level in bands of rows filtered in parallel.
+             *        Each band is processed by its own copy of the filter, the output is identical to the
+             *        single threaded one.
+             *
+             * \param[in] input image.
+             * \param[in] thread pool running the bands.
+             */
+            void build(const image_type &input_image,pandora::thread_pool &pool)
+            {
+                allocate(input_image);
+                for (int i = 1; i < level_count; ++i)
+                {
+                    const image_type &previous = levels[i-1];
+                    image_type &current = levels[i];
+                    const int height = current.height();
+                    const int band_count = std::max(1,std::min(pool.size(),height / minimum_band_height));
+                    
+                    if (band_decimations.size() < static_cast<std::size_t>(band_count))
+                    {
+                        band_decimations.resize(band_count,decimation);
+                    }
+                    
+                    pool.parallel_for(band_count,[&](int band)
+                    {
+                        const int y_begin = height * band / band_count;
+                        const int y_end = height * (band + 1) / band_count;
+                        for (int c = 0; c < previous.spectrum(); ++c)
+                        {
+                            band_decimations[band].apply(previous.data(0,0,0,c),previous.width(),previous.height(),current.data(0,0,0,c),y_begin,y_end);
+                        }
+                    });
+                }
+            }
+            
+            /**
+             * \brief number of levels.
+             */
+            int size() const
+            {
+                return level_count;
+            }
+            
+            /**
+             * \brief level of the pyramid, valid until the next build.
+             *
+             * \param[in] level index, 0 is the input image.
+             * \return level image.
+             */
+            const image_type& operator[](int level) const
+            {
+                return levels[level];
+            }
+            
+         private:
+            
+            /**
+             * \brief lay out the levels of an image size in the arena, and copy the input image to level 0.
+             *        The arena only grows.
+             *
+             * \param[in] input image.
+             */
+            void allocate(const image_type &input_image)
+            {
+                int width = input_image.width();
+                int height = input_image.height();
+                const int spectrum = input_image.spectrum();
+                
+                if (levels.empty() || !levels[0].is_sameXYZC(input_image))
+                {
+                    std::size_t arena_size = 0;
+                    for (int i = 0; i < level_count; ++i, width = (width+1)/2, height = (height+1)/2)
+                    {
+                        arena_size += static_cast<std::size_t>(width)*height*spectrum;
+                    }
+                    if (arena.size() < arena_size)
+                    {
+                        arena.resize(arena_size);
+                    }
+                    
+                    //shared images : the capacity reserved by the constructor keeps them in place
+                    levels.clear();
+                    width = input_image.width();
+                    height = input_image.height();
+                    std::size_t offset = 0;
+                    for (int i = 0; i < level_count; ++i, width = (width+1)/2, height = (height+1)/2)
+                    {
+                        levels.emplace_back(arena.data()+offset,width,height,1,spectrum,true);
+                        offset += static_cast<std::size_t>(width)*height*spectrum;
+                    }
+                }
+                
+                std::copy(input_image.begin(),input_image.end(),levels[0].begin());
+            }
+            
+            //below this height, the halo and the scheduling cost more than what the band brings
+            static constexpr int minimum_band_height = 16;
+            
+            int level_count;
+            details::gaussian_decimation_impl<pixel_type,border> decimation;
+            std::vector<details::gaussian_decimation_impl<pixel_type,border>> band_decimations;
+            std::vector<pixel_type> arena;
+            std::vector<image_type> levels;
+        };
+    }
+    
+    template<typename pixel_type,typename border = filter::border_clamp>
+    using basic_pyramid = filter::gaussian_pyramid<pixel_type,border>;
+    using pyramid = basic_pyramid<uint8_t>;
+}
+
+#endif //__PANDORA_FILTER_GAUSSIAN_PYRAMID_H__
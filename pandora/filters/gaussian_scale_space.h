@@ -0,0 +1,223 @@
+/*BSD 3-Clause License
+
+Copyright (c) 2018, eelcoder
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+* Redistributions of source code must retain the above copyright notice, this
+list of conditions and the following disclaimer.
+
+* Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentation
+and/or other materials provided with the distribution.
+
+* Neither the name of the copyright holder nor the names of its
+contributors may be used to endorse or promote products derived from
+this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+         SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+#ifndef __PANDORA_FILTER_GAUSSIAN_SCALE_SPACE_H__
+#define __PANDORA_FILTER_GAUSSIAN_SCALE_SPACE_H__
+
+#include <pandora/image.h>
+#include <pandora/filters/border.h>
+#include <pandora/filters/details/gaussian_kernel.h>
+#include <pandora/filters/details/gaussian_simd.h>
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace pandora
+{
+    namespace filter
+    {
+        /**
+         * \brief Gaussian scale space : the levels are the input image blurred with the sigmas
+         *        sigma, k x sigma, k2 x sigma ... and the differences of gaussians (DoG) of consecutive levels.
+         *        Each level is filtered from the previous one with the incremental sigma sqrt(s2^2 - s1^2), so the
+         *        kernels stay small whatever the level. The difference with the previous level is computed
+         *        on each output row as soon as it is filtered, while both rows are in the cache.
+         *        The levels are close to the input blurred directly with their sigma, up to the sampling of the
+         *        kernels and to the rounding of the levels for integer pixels : floats are the usual choice.
+         *
+         * \tparam pixel type : float, uint16_t or uint8_t.
+         * \tparam border policy.
+         */
+        template<typename pixel_type = float,typename border = border_clamp>
+        class gaussian_scale_space
+        {
+            using engine_type = details::gaussian_simd_impl<pixel_type,border>;
+            
+         public:
+            
+            using image_type = pandora::image<pixel_type>;
+            
+            /**
+             * \brief constructor.
+             *
+             * \param[in] number of levels, at least 1.
+             * \param[in] sigma of the first level.
+             * \param[in] ratio k of the sigmas of two consecutive levels, above 1.
+             * \param[in] blur already present in the input image (0.5 for a camera image in SIFT), 0 if none.
+             */
+            gaussian_scale_space(int level_count,float sigma,float scale_ratio,float input_sigma = 0.f)
+            {
+                float previous_sigma = input_sigma;
+                float level_sigma = sigma;
+                for (int i = 0; i < std::max(1,level_count); ++i)
+                {
+                    const float increment = std::max(minimum_sigma,std::sqrt(std::max(0.f,level_sigma*level_sigma - previous_sigma*previous_sigma)));
+                    engines.emplace_back(0,0,2*static_cast<int>(std::ceil(3*increment))+1,increment);
+                    sigmas.push_back(level_sigma);
+                    
+                    previous_sigma = level_sigma;
+                    level_sigma *= scale_ratio;
+                }
+            }
+            
+            /**
+             * \brief build the levels and the differences of gaussians of an image.
+             *
+             * \param[in] input image.
+             */
+            void build(const image_type &input_image)
+            {
+                if (levels.size() != engines.size() || !levels[0].is_sameXYZC(input_image))
+                {
+                    levels.assign(engines.size(),image_type(input_image.width(),input_image.height(),1,input_image.spectrum()));
+                    differences.assign(engines.size()-1,pandora::image32f(input_image.width(),input_image.height(),1,input_image.spectrum()));
+                }
+                
+                filter_level(engines[0],input_image,levels[0],nullptr);
+                for (std::size_t i = 1; i < engines.size(); ++i)
+                {
+                    filter_level(engines[i],levels[i-1],levels[i],&differences[i-1]);
+                }
+            }
+            
+            /**
+             * \brief number of levels.
+             */
+            int size() const
+            {
+                return static_cast<int>(engines.size());
+            }
+            
+            /**
+             * \brief level of the scale space, valid until the next build.
+             *
+             * \param[in] level index.
+             * \return input image blurred with the sigma of the level.
+             */
+            const image_type& level(int index) const
+            {
+                return levels[index];
+            }
+            
+            /**
+             * \brief difference of gaussians, valid until the next build.
+             *
+             * \param[in] index, from 0 to size() - 2.
+             * \return level(index+1) - level(index).
+             */
+            const pandora::image32f& difference(int index) const
+            {
+                return differences[index];
+            }
+            
+            /**
+             * \brief sigma of a level.
+             */
+            float sigma(int index) const
+            {
+                return sigmas[index];
+            }
+            
+            /**
+             * \brief kernel filtering a level from the previous one (from the input image for the level 0).
+             */
+            const details::gaussian_kernel& get_kernel(int index) const
+            {
+                return engines[index].get_kernel();
+            }
+            
+         private:
+            
+            /**
+             * \brief filter a level from the previous one, row by row, and the difference of their rows.
+             *
+             * \param[in] filter of the level.
+             * \param[in] previous level.
+             * \param[out] level.
+             * \param[out] difference of gaussians, nullptr for none.
+             */
+            void filter_level(engine_type &engine,const image_type &previous_level,image_type &current_level,pandora::image32f* difference)
+            {
+                const int width = previous_level.width();
+                const int height = previous_level.height();
+                const int kernel_radius = engine.get_vertical_kernel().radius();
+                
+                //the rows are filtered whole, without the column tiles of the image filters
+                engine.reserve(width);
+                
+                for (int c = 0; c < previous_level.spectrum(); ++c)
+                {
+                    const pixel_type* input = previous_level.data(0,0,0,c);
+                    
+                    int previous_source = -1;
+                    for (int y = -kernel_radius; y < kernel_radius; ++y)
+                    {
+                        engine.filter_virtual_row(input,width,height,1,0,width,y,previous_source);
+                    }
+                    
+                    for (int y = 0; y < height; ++y)
+                    {
+                        engine.filter_virtual_row(input,width,height,1,0,width,y+kernel_radius,previous_source);
+                        
+                        pixel_type* output_row = current_level.data(0,y,0,c);
+                        engine.filter_row_vertically(y,width,output_row);
+                        
+                        if (difference)
+                        {
+                            const pixel_type* previous_row = previous_level.data(0,y,0,c);
+                            float* difference_row = difference->data(0,y,0,c);
+                            for (int x = 0; x < width; ++x)
+                            {
+                                difference_row[x] = static_cast<float>(output_row[x]) - static_cast<float>(previous_row[x]);
+                            }
+                        }
+                    }
+                }
+            }
+            
+            //sigma of the levels already blurred enough : a 3 taps kernel of weights 0, 1, 0
+            static constexpr float minimum_sigma = 1e-3f;
+            
+            std::vector<engine_type> engines;
+            std::vector<float> sigmas;
+            std::vector<image_type> levels;
+            std::vector<pandora::image32f> differences;
+        };
+        
+        template<typename pixel_type,typename border>
+        constexpr float gaussian_scale_space<pixel_type,border>::minimum_sigma;
+    }
+    
+    template<typename pixel_type,typename border = filter::border_clamp>
+    using basic_scale_space = filter::gaussian_scale_space<pixel_type,border>;
+    using scale_space = basic_scale_space<float>;
+}
+
+#endif //__PANDORA_FILTER_GAUSSIAN_SCALE_SPACE_H__
@@ -0,0 +1,159 @@
+/*BSD 3-Clause License
+
+Copyright (c) 2018, eelcoder
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+* Redistributions of source code must retain the above copyright notice, this
+list of conditions and the following disclaimer.
+
+* Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentation
+and/or other materials provided with the distribution.
+
+* Neither the name of the copyright holder nor the names of its
+contributors may be used to endorse or promote products derived from
+this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+         SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+#ifndef __PANDORA_FILTER_GAUSSIAN_STREAM_H__
+#define __PANDORA_FILTER_GAUSSIAN_STREAM_H__
+
+#include <pandora/image.h>
+#include <pandora/filters/details/gaussian_simd.h>
+#include <algorithm>
+#include <functional>
+#include <vector>
+
+namespace pandora
+{
+    namespace filter
+    {
+        /**
+         * \brief streaming gaussian filter, for images that do not fit in memory.
+         *        The input is pushed row by row (or strip by strip) and each output row is handed to a
+         *        callback as soon as the kernel_radius rows below it are known. Only kernel_size
+         *        horizontally filtered rows are kept : the memory is O(width x kernel_size).
+         *        The output is identical to gaussian_separable_filter and gaussian_simd_filter.
+         */
+        class gaussian_stream
+        {
+         public:
+            
+            /**
+             * \brief called with the index and the pixels of each output row, the row is only valid during the call.
+             */
+            using row_callback = std::function<void(int,const pandora::image8u::value_type*)>;
+            
+            /**
+             * \brief constructor.
+             *
+             * \param[in] image width.
+             * \param[in] kernel size.
+             * \param[in] kernel sigma.
+             * \param[in] output row callback.
+             */
+            gaussian_stream(int width,int kernel_size,float sigma,row_callback callback):
+                engine(width,0,kernel_size,sigma),width(width),output_row(width),callback(std::move(callback))
+            {
+                //the rows are filtered whole, without the column tiles of the image filters
+                engine.reserve(width);
+            }
+            
+            /**
+             * \brief push the next input row.
+             *
+             * \param[in] input row, width pixels.
+             */
+            void push_row(const pandora::image8u::value_type* input_row)
+            {
+                const int kernel_radius = engine.get_vertical_kernel().radius();
+                
+                engine.filter_row_horizontally(input_row,width,input_rows);
+                if (input_rows == 0)
+                {
+                    //the top border replicates the first row
+                    for (int y = -kernel_radius; y < 0; ++y)
+                    {
+                        engine.copy_filtered_row(0,y,width);
+                    }
+                }
+                ++input_rows;
+                
+                //the rows below the output row are known up to the kernel radius
+                const int y = input_rows - 1 - kernel_radius;
+                if (y >= 0)
+                {
+                    emit_row(y);
+                }
+            }
+            
+            /**
+             * \brief push the next input rows.
+             *
+             * \param[in] strip of rows, width pixels wide.
+             */
+            void push_rows(const pandora::image8u &strip)
+            {
+                for (int y = 0; y < strip.height(); ++y)
+                {
+                    push_row(strip.data(0,y));
+                }
+            }
+            
+            /**
+             * \brief end of the image : emit the last rows, the bottom border is replicated.
+             *        The stream is then ready for a new image.
+             */
+            void finish()
+            {
+                const int kernel_radius = engine.get_vertical_kernel().radius();
+                const int emitted_rows = std::max(0,input_rows - kernel_radius);
+                
+                int next_row = input_rows;
+                for (int y = emitted_rows; y < input_rows; ++y)
+                {
+                    for (; next_row <= y + kernel_radius; ++next_row)
+                    {
+                        engine.copy_filtered_row(input_rows-1,next_row,width);
+                    }
+                    emit_row(y);
+                }
+                input_rows = 0;
+            }
+            
+         private:
+            
+            /**
+             * \brief apply the vertical pass on a row and hand it to the callback.
+             *
+             * \param[in] row to emit.
+             */
+            void emit_row(int y)
+            {
+                engine.filter_row_vertically(y,width,output_row.data());
+                callback(y,output_row.data());
+            }
+            
+            details::gaussian_simd_impl<> engine;
+            int width;
+            int input_rows = 0;
+            std::vector<pandora::image8u::value_type> output_row;
+            row_callback callback;
+        };
+    }
+}
+
+#endif //__PANDORA_FILTER_GAUSSIAN_STREAM_H__
@@ -0,0 +1,159 @@
+/*BSD 3-Clause License
+
+Copyright (c) 2018, eelcoder
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+* Redistributions of source code must retain the above copyright notice, this
+list of conditions and the following disclaimer.
+
+* Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentation
+and/or other materials provided with the distribution.
+
+* Neither the name of the copyright holder nor the names of its
+contributors may be used to endorse or promote products derived from
+this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+         SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+#ifndef __PANDORA_FILTER_UNSHARP_MASK_H__
+#define __PANDORA_FILTER_UNSHARP_MASK_H__
+
+#include <pandora/image.h>
+#include <pandora/cpu_features.h>
+#include <pandora/filters/border.h>
+#include <pandora/filters/details/gaussian_simd.h>
+#include <pandora/filters/details/sharpen_row.h>
+#include <algorithm>
+#include <vector>
+
+namespace pandora
+{
+    namespace filter
+    {
+        /**
+         * \brief Unsharp mask sharpening : output = input + amount x (input - blurred input), where the difference
+         *        with the blurred input is at least the threshold, the input otherwise.
+         *        The blur is the gaussian filter of the separable engine, driven row by row : each row leaving the
+         *        vertical pass is sharpened with its input row at once, so no blurred image is allocated and
+         *        the image is traversed once. The output is rounded and saturated to the pixel range.
+         *
+         * \tparam pixel type : uint8_t, uint16_t or float.
+         * \tparam border policy.
+         */
+        template<typename pixel_type = uint8_t,typename border = border_clamp>
+        class unsharp_mask
+        {
+         public:
+            
+            using image_type = pandora::image<pixel_type>;
+            
+            /**
+             * \brief constructor.
+             *
+             * \param[in] kernel size of the blur.
+             * \param[in] gaussian sigma of the blur.
+             * \param[in] amount of sharpening, 0 for none.
+             * \param[in] smallest difference with the blurred pixel sharpened, 0 to sharpen all the pixels.
+             * \param[in] instruction set to use, limited to the ones supported by the cpu.
+             */
+            unsharp_mask(int kernel_size,float sigma,float amount,float threshold = 0.f,
+                         pandora::simd_level requested_level = pandora::cpu_simd_level()):
+                engine(0,0,kernel_size,sigma,requested_level),level(std::min(requested_level,pandora::cpu_simd_level())),
+                amount(amount),threshold(threshold)
+            {
+            }
+            
+            /**
+             * \brief sharpen all the channels of an image.
+             *
+             * \param[in] input image.
+             * \param[out] output image, of the size of the input image and not sharing its pixels.
+             */
+            void apply(const image_type &input_image,image_type &output_image)
+            {
+                const int width = input_image.width();
+                const int height = input_image.height();
+                
+                const int tile_width = engine.tile_columns(width,1);
+                engine.reserve(tile_width);
+                if (static_cast<int>(blurred_row.size()) < tile_width)
+                {
+                    blurred_row.resize(tile_width);
+                }
+                
+                for (int c = 0; c < input_image.spectrum(); ++c)
+                {
+                    for (int x_begin = 0; x_begin < width; x_begin += tile_width)
+                    {
+                        apply_tile(input_image.data(0,0,0,c),output_image.data(0,0,0,c),width,height,x_begin,std::min(width,x_begin+tile_width));
+                    }
+                }
+            }
+            
+            /**
+             * \brief apply the filter, see apply.
+             */
+            void operator()(const image_type &input_image,image_type &output_image)
+            {
+                apply(input_image,output_image);
+            }
+            
+         private:
+            
+            /**
+             * \brief sharpen a tile of columns of an image plane.
+             *
+             * \param[in] input plane.
+             * \param[out] output plane.
+             * \param[in] plane width.
+             * \param[in] plane height.
+             * \param[in] first column of the tile.
+             * \param[in] column following the tile.
+             */
+            void apply_tile(const pixel_type* input,pixel_type* output,int width,int height,int x_begin,int x_end)
+            {
+                const int kernel_radius = engine.get_vertical_kernel().radius();
+                
+                int previous_source = -1;
+                for (int y = -kernel_radius; y < kernel_radius; ++y)
+                {
+                    engine.filter_virtual_row(input,width,height,1,x_begin,x_end,y,previous_source);
+                }
+                
+                for (int y = 0; y < height; ++y)
+                {
+                    engine.filter_virtual_row(input,width,height,1,x_begin,x_end,y+kernel_radius,previous_source);
+                    engine.filter_row_vertically(y,x_end-x_begin,blurred_row.data());
+                    
+                    const std::size_t row_offset = static_cast<std::size_t>(y)*width + x_begin;
+                    details::sharpen_row(level,input+row_offset,blurred_row.data(),x_end-x_begin,amount,threshold,output+row_offset);
+                }
+            }
+            
+            details::gaussian_simd_impl<pixel_type,border> engine;
+            pandora::simd_level level;
+            float amount;
+            float threshold;
+            std::vector<pixel_type> blurred_row;
+        };
+    }
+    
+    template<typename pixel_type,typename border = filter::border_clamp>
+    using basic_unsharp_mask_filter = filter::unsharp_mask<pixel_type,border>;
+    using unsharp_mask_filter = basic_unsharp_mask_filter<uint8_t>;
+}
+
+#endif //__PANDORA_FILTER_UNSHARP_MASK_H__
@@ -33,6 +33,7 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #define cimg_display 0
 #include "CImg.h"
+#include <cstdint>
 
 namespace pandora
 {
@@ -41,6 +42,8 @@ namespace pandora
 
     using image8u = image<uint8_t>;
     using image8s = image<int8_t>;
+    using image16u = image<uint16_t>;
+    using image32f = image<float>;
 }
 
 #endif //__PANDORA_IMAGE_H__
\ No newline at end of file
@@ -0,0 +1,156 @@
+/*BSD 3-Clause License
+
+Copyright (c) 2018, eelcoder
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+* Redistributions of source code must retain the above copyright notice, this
+list of conditions and the following disclaimer.
+
+* Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentation
+and/or other materials provided with the distribution.
+
+* Neither the name of the copyright holder nor the names of its
+contributors may be used to endorse or promote products derived from
+this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+         SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+#ifndef __PANDORA_REGION_H__
+#define __PANDORA_REGION_H__
+
+#include <algorithm>
+#include <vector>
+
+namespace pandora
+{
+    /**
+     * \brief rectangle of pixels : the columns [x,x+width) of the rows [y,y+height).
+     */
+    struct region
+    {
+        int x;
+        int y;
+        int width;
+        int height;
+        
+        int area() const
+        {
+            return width * height;
+        }
+        
+        bool empty() const
+        {
+            return width <= 0 || height <= 0;
+        }
+        
+        bool intersects(const region &other) const
+        {
+            return x < other.x + other.width && other.x < x + width &&
+                   y < other.y + other.height && other.y < y + height;
+        }
+        
+        bool operator==(const region &other) const
+        {
+            return x == other.x && y == other.y && width == other.width && height == other.height;
+        }
+    };
+    
+    /**
+     * \brief intersection of two regions, empty if they do not intersect.
+     */
+    inline region intersection(const region &a,const region &b)
+    {
+        const int x = std::max(a.x,b.x);
+        const int y = std::max(a.y,b.y);
+        return region{x,y,std::max(0,std::min(a.x+a.width,b.x+b.width)-x),std::max(0,std::min(a.y+a.height,b.y+b.height)-y)};
+    }
+    
+    /**
+     * \brief smallest region holding two regions.
+     */
+    inline region bounding_region(const region &a,const region &b)
+    {
+        const int x = std::min(a.x,b.x);
+        const int y = std::min(a.y,b.y);
+        return region{x,y,std::max(a.x+a.width,b.x+b.width)-x,std::max(a.y+a.height,b.y+b.height)-y};
+    }
+    
+    /**
+     * \brief cover the union of regions with disjoint regions, clipped to a bounding region,
+     *        so that a pixel shared by several regions is processed once.
+     *        Two overlapping regions are merged into their bounding region when it covers exactly their
+     *        union (no pixel outside of both), otherwise the overlap is cut out of one of them (in at most 4 regions).
+     *
+     * \param[in] regions, possibly overlapping.
+     * \param[in] bounding region, usually the image.
+     * \return disjoint regions.
+     */
+    inline std::vector<region> disjoint_regions(const std::vector<region> &regions,const region &bounds)
+    {
+        std::vector<region> pending;
+        for (const auto& r : regions)
+        {
+            const region clipped = intersection(r,bounds);
+            if (!clipped.empty())
+            {
+                pending.push_back(clipped);
+            }
+        }
+        
+        std::vector<region> disjoint;
+        while (!pending.empty())
+        {
+            const region r = pending.back();
+            pending.pop_back();
+            
+            auto overlapping = std::find_if(disjoint.begin(),disjoint.end(),[&](const region &d){ return d.intersects(r); });
+            if (overlapping == disjoint.end())
+            {
+                disjoint.push_back(r);
+                continue;
+            }
+            
+            const region d = *overlapping;
+            const region merged = bounding_region(d,r);
+            if (merged.area() == d.area() + r.area() - intersection(d,r).area())
+            {
+                //the merged region may overlap other regions, it goes back to the pending ones
+                disjoint.erase(overlapping);
+                pending.push_back(merged);
+            }
+            else
+            {
+                //the parts of r above, below, left and right of d
+                const region common = intersection(d,r);
+                const region parts[] = {
+                    {r.x,r.y,r.width,common.y-r.y},
+                    {r.x,common.y+common.height,r.width,r.y+r.height-common.y-common.height},
+                    {r.x,common.y,common.x-r.x,common.height},
+                    {common.x+common.width,common.y,r.x+r.width-common.x-common.width,common.height}};
+                for (const auto& part : parts)
+                {
+                    if (!part.empty())
+                    {
+                        pending.push_back(part);
+                    }
+                }
+            }
+        }
+        return disjoint;
+    }
+}
+
+#endif //__PANDORA_REGION_H__
@@ -0,0 +1,191 @@
+/*BSD 3-Clause License
+
+Copyright (c) 2018, eelcoder
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+* Redistributions of source code must retain the above copyright notice, this
+list of conditions and the following disclaimer.
+
+* Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentation
+and/or other materials provided with the distribution.
+
+* Neither the name of the copyright holder nor the names of its
+contributors may be used to endorse or promote products derived from
+this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+         SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+#ifndef __PANDORA_THREAD_POOL_H__
+#define __PANDORA_THREAD_POOL_H__
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace pandora
+{
+    /**
+     * \brief persistent pool of threads running batches of indexed tasks.
+     *        The calling thread takes part in the batch, so a pool of N threads owns N-1 workers.
+     *
+     * \remark the tasks must not throw.
+     */
+    class thread_pool
+    {
+        
+    public:
+        
+        /**
+         * \brief constructor.
+         *
+         * \param[in] number of threads running the tasks, including the calling thread.
+         */
+        explicit thread_pool(int thread_count = static_cast<int>(std::thread::hardware_concurrency())):
+            thread_count(std::max(1,thread_count))
+        {
+            for (int i = 1; i < this->thread_count; ++i)
+            {
+                workers.emplace_back([this]{ work(); });
+            }
+        }
+        
+        thread_pool(const thread_pool&) = delete;
+        thread_pool& operator=(const thread_pool&) = delete;
+        
+        /**
+         * \brief destructor, waits for the workers to stop.
+         */
+        ~thread_pool()
+        {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                stopping = true;
+            }
+            work_available.notify_all();
+            
+            for (auto& worker : workers)
+            {
+                worker.join();
+            }
+        }
+        
+        /**
+         * \brief number of threads running the tasks, including the calling thread.
+         */
+        int size() const
+        {
+            return thread_count;
+        }
+        
+        /**
+         * \brief run task(0) ... task(task_count-1) on the pool and wait for their completion.
+         *
+         * \param[in] number of tasks.
+         * \param[in] task, called with the task index.
+         */
+        void parallel_for(int task_count,const std::function<void(int)> &task)
+        {
+            if (task_count <= 0)
+            {
+                return;
+            }
+            
+            std::unique_lock<std::mutex> lock(mutex);
+            current_task = &task;
+            task_total = task_count;
+            finished_tasks = 0;
+            next_task = 0;
+            ++generation;
+            lock.unlock();
+            work_available.notify_all();
+            
+            run_tasks();
+            
+            //wait for the last tasks, and for the workers to leave the batch before it goes out of scope
+            lock.lock();
+            batch_done.wait(lock,[this]{ return finished_tasks == task_total && active_workers == 0; });
+            current_task = nullptr;
+        }
+        
+    private:
+        
+        /**
+         * \brief worker loop : wait for a new batch of tasks and take part in it.
+         */
+        void work()
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            unsigned int seen_generation = generation;
+            
+            while (true)
+            {
+                work_available.wait(lock,[&]{ return stopping || generation != seen_generation; });
+                if (stopping)
+                {
+                    return;
+                }
+                
+                seen_generation = generation;
+                ++active_workers;
+                lock.unlock();
+                
+                run_tasks();
+                
+                lock.lock();
+                --active_workers;
+                batch_done.notify_all();
+            }
+        }
+        
+        /**
+         * \brief run the tasks of the current batch until there is none left.
+         */
+        void run_tasks()
+        {
+            for (int task = next_task++; task < task_total; task = next_task++)
+            {
+                (*current_task.load())(task);
+                
+                if (++finished_tasks == task_total)
+                {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    batch_done.notify_all();
+                }
+            }
+        }
+        
+        int thread_count;
+        std::vector<std::thread> workers;
+        
+        std::mutex mutex;
+        std::condition_variable work_available;
+        std::condition_variable batch_done;
+        bool stopping = false;
+        unsigned int generation = 0;
+        int active_workers = 0;
+        
+        std::atomic<const std::function<void(int)>*> current_task{nullptr};
+        std::atomic<int> task_total{0};
+        std::atomic<int> next_task{0};
+        std::atomic<int> finished_tasks{0};
+    };
+}
+
+#endif //__PANDORA_THREAD_POOL_H__
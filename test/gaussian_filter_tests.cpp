@@ -31,9 +31,20 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 */
 #include "catch.hpp"
 
+#include <algorithm>
 #include <random>
 #include <cmath>
+#include <cstdio>
+#include <string>
+#include <vector>
 #include "pandora/filters/gaussian.h"
+#include "pandora/filters/gaussian_stream.h"
+#include "pandora/filters/gaussian_incremental.h"
+#include "pandora/filters/gaussian_derivatives.h"
+#include "pandora/filters/gaussian_pyramid.h"
+#include "pandora/filters/gaussian_scale_space.h"
+#include "pandora/filters/unsharp_mask.h"
+#include "pandora/filters/gaussian_planner.h"
 
 SCENARIO("gaussian filter effectiveness", "[gaussian][filter]")
 {
@@ -137,3 +148,1757 @@ SCENARIO("gaussian filter implementations similarity", "[gaussian][filter]")
 		}
 	}
 }
+
+SCENARIO("gaussian kernel table", "[gaussian][kernel]")
+{
+    GIVEN("A 1D gaussian kernel")
+    {
+        constexpr int kernel_diameter = 7;
+        constexpr float sigma = 2.f;
+        
+        pandora::filter::details::gaussian_kernel kernel(kernel_diameter,sigma);
+        
+        THEN("the kernel should be normalized and symmetric")
+        {
+            REQUIRE(kernel.radius() == kernel_diameter/2);
+            REQUIRE(kernel.size() == kernel_diameter);
+            
+            float sum_weight = 0;
+            for (int x = -kernel.radius(); x <= kernel.radius(); ++x)
+            {
+                sum_weight += kernel[x];
+                REQUIRE(kernel[x] == kernel[-x]);
+                REQUIRE(kernel[x] <= kernel[0]);
+            }
+            REQUIRE(std::abs(sum_weight - 1.f) < 1e-5f);
+        }
+        
+        THEN("the fixed point weights should sum exactly to one and be symmetric")
+        {
+            const uint16_t* fixed_weights = kernel.fixed_data();
+            
+            int sum_weight = 0;
+            for (int k = 0; k < kernel.size(); ++k)
+            {
+                sum_weight += fixed_weights[k];
+                REQUIRE(fixed_weights[k] == fixed_weights[kernel.size()-1-k]);
+            }
+            REQUIRE(sum_weight == (1 << pandora::filter::details::gaussian_kernel::fixed_point_shift));
+        }
+    }
+}
+
+SCENARIO("fixed point gaussian filter exactness", "[gaussian][filter]")
+{
+    GIVEN("A grayscale noisy image")
+    {
+        constexpr int image_width = 320;
+        constexpr int image_height = 240;
+        
+        pandora::image8u input_image(image_width,image_height,1,1,0);
+        pandora::image8u output_image(image_width,image_height,1,1,0);
+        
+        constexpr int kernel_diameter = 5;
+        constexpr float sigma = 10.f;
+        
+        pandora::gaussian_separable_filter separable_filter(image_width,image_height,kernel_diameter,sigma);
+        
+        constexpr double mean = 128.0;
+        constexpr double stddev = 50;
+        std::default_random_engine generator;
+        std::normal_distribution<double> dist(mean, stddev);
+        
+        for (auto& pixel_value : input_image)
+        {
+            pixel_value += dist(generator);
+        }
+        
+        WHEN("apply the separable gaussian filter")
+        {
+            separable_filter(input_image,output_image);
+            
+            THEN("the blurred image should be identical to the 2D fixed point convolution")
+            {
+                pandora::filter::details::gaussian_kernel kernel(kernel_diameter,sigma);
+                const int kernel_radius = kernel.radius();
+                const uint16_t* weights = kernel.fixed_data() + kernel_radius;
+                
+                pandora::image8u reference_image(image_width,image_height,1,1,0);
+                for (int y_center = 0; y_center < image_height; ++y_center)
+                {
+                    for (int x_center = 0; x_center < image_width; ++x_center)
+                    {
+                        uint32_t sum = 0;
+                        for (int y = -kernel_radius; y <= kernel_radius; ++y)
+                        {
+                            for (int x = -kernel_radius; x <= kernel_radius; ++x)
+                            {
+                                int x_neighbor = std::max(0,std::min(x_center+x,image_width-1));
+                                int y_neighbor = std::max(0,std::min(y_center+y,image_height-1));
+                                
+                                sum += weights[x]*weights[y]*input_image(x_neighbor,y_neighbor);
+                            }
+                        }
+                        reference_image(x_center,y_center) = static_cast<uint8_t>((sum + (1 << 15)) >> 16);
+                    }
+                }
+                
+                REQUIRE(output_image == reference_image);
+            }
+        }
+    }
+}
+
+SCENARIO("gaussian filter tiled in columns", "[gaussian][filter][tile]")
+{
+    GIVEN("A grayscale noisy image too wide for the ring buffer of a large kernel")
+    {
+        //the ring buffer of 101 rows exceeds the cache budget : the image is processed in 3 tiles of columns
+        constexpr int image_width = 1301;
+        constexpr int image_height = 57;
+        
+        pandora::image8u input_image(image_width,image_height,1,1,0);
+        
+        std::default_random_engine generator;
+        std::uniform_int_distribution<int> dist(0,255);
+        for (auto& pixel_value : input_image)
+        {
+            pixel_value = static_cast<pandora::image8u::value_type>(dist(generator));
+        }
+        
+        constexpr int kernel_diameter = 101;
+        constexpr float sigma = 16.f;
+        
+        WHEN("apply the separable gaussian filters")
+        {
+            pandora::image8u separable_image(image_width,image_height,1,1,0);
+            pandora::gaussian_separable_filter separable_filter(image_width,image_height,kernel_diameter,sigma);
+            separable_filter(input_image,separable_image);
+            
+            pandora::image8u simd_image(image_width,image_height,1,1,0);
+            pandora::gaussian_simd_filter simd_filter(image_width,image_height,kernel_diameter,sigma);
+            simd_filter(input_image,simd_image);
+            
+            THEN("the blurred images should be identical to the untiled fixed point convolution")
+            {
+                pandora::filter::details::gaussian_kernel kernel(kernel_diameter,sigma);
+                const int kernel_radius = kernel.radius();
+                const uint16_t* weights = kernel.fixed_data() + kernel_radius;
+                
+                std::vector<uint32_t> horizontal_image(image_width*image_height);
+                for (int y = 0; y < image_height; ++y)
+                {
+                    for (int x_center = 0; x_center < image_width; ++x_center)
+                    {
+                        uint32_t sum = 0;
+                        for (int x = -kernel_radius; x <= kernel_radius; ++x)
+                        {
+                            sum += weights[x]*input_image(std::max(0,std::min(x_center+x,image_width-1)),y);
+                        }
+                        horizontal_image[y*image_width+x_center] = sum;
+                    }
+                }
+                
+                pandora::image8u reference_image(image_width,image_height,1,1,0);
+                for (int y_center = 0; y_center < image_height; ++y_center)
+                {
+                    for (int x = 0; x < image_width; ++x)
+                    {
+                        uint32_t sum = 0;
+                        for (int y = -kernel_radius; y <= kernel_radius; ++y)
+                        {
+                            sum += weights[y]*horizontal_image[std::max(0,std::min(y_center+y,image_height-1))*image_width+x];
+                        }
+                        reference_image(x,y_center) = static_cast<uint8_t>((sum + (1 << 15)) >> 16);
+                    }
+                }
+                
+                REQUIRE(separable_image == reference_image);
+                REQUIRE(simd_image == reference_image);
+            }
+        }
+    }
+}
+
+SCENARIO("vectorized gaussian filter instruction sets", "[gaussian][filter][simd]")
+{
+    GIVEN("A grayscale noisy image whose width is not a multiple of the vector size")
+    {
+        constexpr int image_width = 333;
+        constexpr int image_height = 241;
+        
+        pandora::image8u input_image(image_width,image_height,1,1,0);
+        
+        std::default_random_engine generator;
+        std::uniform_int_distribution<int> dist(0,255);
+        for (auto& pixel_value : input_image)
+        {
+            pixel_value = static_cast<pandora::image8u::value_type>(dist(generator));
+        }
+        
+        WHEN("apply the gaussian blur with every supported instruction set")
+        {
+            THEN("the blurred images should be identical to the scalar path and close to the naive filter")
+            {
+                for (int kernel_diameter : {3,5,7,15})
+                {
+                    constexpr float sigma = 3.f;
+                    
+                    pandora::image8u naive_image(image_width,image_height,1,1,0);
+                    pandora::gaussian_naive_filter naive_filter(kernel_diameter,sigma);
+                    naive_filter(input_image,naive_image);
+                    
+                    pandora::image8u scalar_image(image_width,image_height,1,1,0);
+                    pandora::filter::details::gaussian_separable_impl<> scalar_filter(image_width,image_height,kernel_diameter,sigma);
+                    scalar_filter.apply(input_image,scalar_image);
+                    
+                    bool are_close = std::equal(naive_image.begin(), naive_image.end(), scalar_image.begin(),
+                    [](auto a, auto b)
+                    {
+                        return std::abs(a-b) <=1;
+                    });
+                    REQUIRE(are_close == true);
+                    
+                    for (auto level : {pandora::simd_level::scalar,pandora::simd_level::sse41,pandora::simd_level::avx2})
+                    {
+                        pandora::image8u simd_image(image_width,image_height,1,1,0);
+                        pandora::filter::details::gaussian_simd_impl<> simd_filter(image_width,image_height,kernel_diameter,sigma,level);
+                        simd_filter.apply(input_image,simd_image);
+                        
+                        REQUIRE(simd_image == scalar_image);
+                    }
+                }
+            }
+        }
+    }
+}
+
+SCENARIO("gaussian filter specialized for a kernel size", "[gaussian][filter][fixed]")
+{
+    GIVEN("A grayscale noisy image whose width is not a multiple of the vector size")
+    {
+        constexpr int image_width = 333;
+        constexpr int image_height = 241;
+        
+        pandora::image8u input_image(image_width,image_height,1,1,0);
+        
+        std::default_random_engine generator;
+        std::uniform_int_distribution<int> dist(0,255);
+        for (auto& pixel_value : input_image)
+        {
+            pixel_value = static_cast<pandora::image8u::value_type>(dist(generator));
+        }
+        
+        constexpr float sigma = 2.f;
+        
+        WHEN("apply the gaussian blur with the specialized filters")
+        {
+            pandora::image8u fixed3_image(image_width,image_height,1,1,0);
+            pandora::image8u fixed5_image(image_width,image_height,1,1,0);
+            pandora::image8u fixed9_image(image_width,image_height,1,1,0);
+            
+            pandora::gaussian_fixed_filter<3> fixed3_filter(image_width,image_height,3,sigma);
+            pandora::gaussian_fixed_filter<5> fixed5_filter(image_width,image_height,5,sigma);
+            pandora::gaussian_fixed_filter<9> fixed9_filter(image_width,image_height,9,sigma);
+            fixed3_filter(input_image,fixed3_image);
+            fixed5_filter(input_image,fixed5_image);
+            fixed9_filter(input_image,fixed9_image);
+            
+            THEN("the blurred images should be identical to the separable filter")
+            {
+                for (auto fixed : {std::make_pair(3,&fixed3_image),std::make_pair(5,&fixed5_image),std::make_pair(9,&fixed9_image)})
+                {
+                    pandora::image8u separable_image(image_width,image_height,1,1,0);
+                    pandora::gaussian_separable_filter separable_filter(image_width,image_height,fixed.first,sigma);
+                    separable_filter(input_image,separable_image);
+                    
+                    REQUIRE(*fixed.second == separable_image);
+                }
+            }
+        }
+        
+        WHEN("apply a specialized filter built with another kernel size")
+        {
+            pandora::image8u fixed_image(image_width,image_height,1,1,0);
+            pandora::gaussian_fixed_filter<5>(image_width,image_height,7,sigma)(input_image,fixed_image);
+            
+            THEN("the blurred image should be the one of the requested kernel size")
+            {
+                pandora::image8u separable_image(image_width,image_height,1,1,0);
+                pandora::gaussian_separable_filter(image_width,image_height,7,sigma)(input_image,separable_image);
+                
+                REQUIRE(fixed_image == separable_image);
+            }
+        }
+    }
+}
+
+SCENARIO("gaussian filter border policies", "[gaussian][filter][border]")
+{
+    GIVEN("Grayscale noisy images, one smaller than the kernel")
+    {
+        std::default_random_engine generator;
+        std::uniform_int_distribution<int> dist(0,255);
+        
+        pandora::image8u large_image(133,71,1,1,0);
+        pandora::image8u small_image(5,4,1,1,0);
+        for (auto image : {&large_image,&small_image})
+        {
+            for (auto& pixel_value : *image)
+            {
+                pixel_value = static_cast<pandora::image8u::value_type>(dist(generator));
+            }
+        }
+        
+        constexpr int kernel_diameter = 11;
+        constexpr float sigma = 2.f;
+        
+        WHEN("apply the gaussian blur with each border policy")
+        {
+            THEN("the separable and vectorized filters should be close to the naive filter and identical to each other")
+            {
+                auto check = [&](auto policy)
+                {
+                    using border = decltype(policy);
+                    
+                    for (auto image : {&large_image,&small_image})
+                    {
+                        const int width = image->width();
+                        const int height = image->height();
+                        
+                        pandora::image8u naive_image(width,height,1,1,0);
+                        pandora::gaussian_naive_border_filter<border> naive_filter(kernel_diameter,sigma);
+                        naive_filter(*image,naive_image);
+                        
+                        pandora::image8u separable_image(width,height,1,1,0);
+                        pandora::gaussian_separable_border_filter<border> separable_filter(width,height,kernel_diameter,sigma);
+                        separable_filter(*image,separable_image);
+                        
+                        pandora::image8u simd_image(width,height,1,1,0);
+                        pandora::gaussian_simd_border_filter<border> simd_filter(width,height,kernel_diameter,sigma);
+                        simd_filter(*image,simd_image);
+                        
+                        bool are_close = std::equal(naive_image.begin(), naive_image.end(), separable_image.begin(),
+                        [](auto a, auto b)
+                        {
+                            return std::abs(a-b) <=1;
+                        });
+                        REQUIRE(are_close == true);
+                        REQUIRE(simd_image == separable_image);
+                    }
+                };
+                
+                check(pandora::filter::border_clamp());
+                check(pandora::filter::border_reflect101());
+                check(pandora::filter::border_wrap());
+                check(pandora::filter::border_constant<128>());
+            }
+            
+            THEN("a constant border should take any value of the 16 bit and floating point ranges")
+            {
+                auto check = [&](auto pixel,auto policy,float tolerance)
+                {
+                    using pixel_type = decltype(pixel);
+                    using border = decltype(policy);
+                    using image_type = pandora::image<pixel_type>;
+                    
+                    const int width = large_image.width();
+                    const int height = large_image.height();
+                    const image_type input_image(large_image);
+                    
+                    image_type naive_image(width,height,1,1,0);
+                    pandora::basic_gaussian_naive_filter<pixel_type,border>(kernel_diameter,sigma)(input_image,naive_image);
+                    
+                    image_type simd_image(width,height,1,1,0);
+                    pandora::basic_gaussian_simd_filter<pixel_type,border>(width,height,kernel_diameter,sigma)(input_image,simd_image);
+                    
+                    for (int y = 0; y < height; ++y)
+                    {
+                        for (int x = 0; x < width; ++x)
+                        {
+                            if (std::abs(static_cast<float>(simd_image(x,y)) - static_cast<float>(naive_image(x,y))) > tolerance)
+                            {
+                                FAIL("border " << static_cast<float>(border::value) << " pixel " << x << "," << y);
+                            }
+                        }
+                    }
+                    
+                    //the corner pixel sees mostly the border : it is pulled towards the constant
+                    return static_cast<float>(naive_image(0,0));
+                };
+                
+                REQUIRE(check(uint16_t(),pandora::filter::border_constant<1000>(),1.f) > 300);
+                REQUIRE(check(float(),pandora::filter::border_constant<-500>(),1e-2f) < -50.f);
+                
+                //8 bit pixels saturate the constant
+                pandora::image8u saturated_image(large_image.width(),large_image.height(),1,1,0);
+                pandora::gaussian_simd_border_filter<pandora::filter::border_constant<1000>>(large_image.width(),large_image.height(),kernel_diameter,sigma)(large_image,saturated_image);
+                pandora::image8u white_image(large_image.width(),large_image.height(),1,1,0);
+                pandora::gaussian_simd_border_filter<pandora::filter::border_constant<255>>(large_image.width(),large_image.height(),kernel_diameter,sigma)(large_image,white_image);
+                REQUIRE(saturated_image == white_image);
+            }
+        }
+    }
+}
+
+SCENARIO("multithreaded gaussian filter", "[gaussian][filter][thread]")
+{
+    GIVEN("A grayscale noisy image and a thread pool")
+    {
+        constexpr int image_width = 333;
+        constexpr int image_height = 241;
+        
+        pandora::image8u input_image(image_width,image_height,1,1,0);
+        
+        std::default_random_engine generator;
+        std::uniform_int_distribution<int> dist(0,255);
+        for (auto& pixel_value : input_image)
+        {
+            pixel_value = static_cast<pandora::image8u::value_type>(dist(generator));
+        }
+        
+        pandora::thread_pool pool(4);
+        
+        constexpr int kernel_diameter = 9;
+        constexpr float sigma = 3.f;
+        
+        WHEN("apply the gaussian blur on bands of the image")
+        {
+            THEN("the blurred images should be identical to the single threaded ones")
+            {
+                pandora::image8u single_image(image_width,image_height,1,1,0);
+                pandora::image8u threaded_image(image_width,image_height,1,1,0);
+                
+                pandora::gaussian_naive_filter naive_filter(kernel_diameter,sigma);
+                naive_filter(input_image,single_image);
+                naive_filter(input_image,threaded_image,pool);
+                REQUIRE(threaded_image == single_image);
+                
+                pandora::gaussian_separable_filter separable_filter(image_width,image_height,kernel_diameter,sigma);
+                separable_filter(input_image,single_image);
+                threaded_image.fill(0);
+                separable_filter(input_image,threaded_image,pool);
+                REQUIRE(threaded_image == single_image);
+                
+                pandora::gaussian_simd_filter simd_filter(image_width,image_height,kernel_diameter,sigma);
+                simd_filter(input_image,single_image);
+                for (int i = 0; i < 3; ++i)
+                {
+                    threaded_image.fill(0);
+                    simd_filter(input_image,threaded_image,pool);
+                    REQUIRE(threaded_image == single_image);
+                }
+            }
+        }
+    }
+}
+
+SCENARIO("recursive gaussian filter accuracy", "[gaussian][filter][recursive]")
+{
+    GIVEN("A grayscale noisy image")
+    {
+        constexpr int image_width = 320;
+        constexpr int image_height = 240;
+        
+        pandora::image8u input_image(image_width,image_height,1,1,0);
+        pandora::image8u naive_image(image_width,image_height,1,1,0);
+        pandora::image8u recursive_image(image_width,image_height,1,1,0);
+        
+        std::default_random_engine generator;
+        std::uniform_int_distribution<int> dist(0,255);
+        for (auto& pixel_value : input_image)
+        {
+            pixel_value = static_cast<pandora::image8u::value_type>(dist(generator));
+        }
+        
+        WHEN("apply the recursive gaussian filter")
+        {
+            constexpr float sigma = 5.f;
+            constexpr int kernel_diameter = 31;
+            
+            pandora::gaussian_naive_filter naive_filter(kernel_diameter,sigma);
+            pandora::gaussian_recursive_filter recursive_filter(image_width,image_height,kernel_diameter,sigma);
+            
+            naive_filter(input_image,naive_image);
+            recursive_filter(input_image,recursive_image);
+            
+            THEN("the blurred image should be close to the naive filter with a +-3 sigma kernel")
+            {
+                bool are_close = std::equal(naive_image.begin(), naive_image.end(), recursive_image.begin(),
+                [](auto a, auto b)
+                {
+                    return std::abs(a-b) <=2;
+                });
+                REQUIRE(are_close == true);
+            }
+        }
+    }
+}
+
+SCENARIO("box approximation of the gaussian filter accuracy", "[gaussian][filter][box]")
+{
+    GIVEN("A grayscale noisy image")
+    {
+        constexpr int image_width = 320;
+        constexpr int image_height = 240;
+        
+        pandora::image8u input_image(image_width,image_height,1,1,0);
+        pandora::image8u naive_image(image_width,image_height,1,1,0);
+        pandora::image8u box_image(image_width,image_height,1,1,0);
+        
+        std::default_random_engine generator;
+        std::uniform_int_distribution<int> dist(0,255);
+        for (auto& pixel_value : input_image)
+        {
+            pixel_value = static_cast<pandora::image8u::value_type>(dist(generator));
+        }
+        
+        WHEN("apply the iterated box filters")
+        {
+            constexpr float sigma = 5.f;
+            constexpr int kernel_diameter = 31;
+            
+            pandora::gaussian_naive_filter naive_filter(kernel_diameter,sigma);
+            naive_filter(input_image,naive_image);
+            
+            THEN("the blurred image should be close to the naive filter with a +-3 sigma kernel")
+            {
+                pandora::gaussian_box_filter<3> box_filter(image_width,image_height,kernel_diameter,sigma);
+                box_filter(input_image,box_image);
+                
+                bool are_close = std::equal(naive_image.begin(), naive_image.end(), box_image.begin(),
+                [](auto a, auto b)
+                {
+                    return std::abs(a-b) <=2;
+                });
+                REQUIRE(are_close == true);
+                
+                pandora::gaussian_box_filter<5> five_box_filter(image_width,image_height,kernel_diameter,sigma);
+                five_box_filter(input_image,box_image);
+                
+                are_close = std::equal(naive_image.begin(), naive_image.end(), box_image.begin(),
+                [](auto a, auto b)
+                {
+                    return std::abs(a-b) <=2;
+                });
+                REQUIRE(are_close == true);
+            }
+        }
+    }
+}
+
+SCENARIO("frequency domain gaussian filter", "[gaussian][filter][fft]")
+{
+    GIVEN("A grayscale noisy image whose sizes are not powers of two")
+    {
+        constexpr int image_width = 333;
+        constexpr int image_height = 241;
+        
+        pandora::image8u input_image(image_width,image_height,1,1,0);
+        
+        std::default_random_engine generator;
+        std::uniform_int_distribution<int> dist(0,255);
+        for (auto& pixel_value : input_image)
+        {
+            pixel_value = static_cast<pandora::image8u::value_type>(dist(generator));
+        }
+        
+        constexpr int kernel_diameter = 31;
+        constexpr float sigma = 5.f;
+        
+        WHEN("apply the gaussian blur in the frequency domain")
+        {
+            pandora::image8u naive_image(image_width,image_height,1,1,0);
+            pandora::gaussian_naive_filter naive_filter(kernel_diameter,sigma);
+            naive_filter(input_image,naive_image);
+            
+            pandora::image8u fft_image(image_width,image_height,1,1,0);
+            pandora::gaussian_fft_filter fft_filter(image_width,image_height,kernel_diameter,sigma);
+            fft_filter(input_image,fft_image);
+            
+            pandora::image8u reflect_naive_image(image_width,image_height,1,1,0);
+            pandora::gaussian_naive_border_filter<pandora::filter::border_reflect101> reflect_naive_filter(kernel_diameter,sigma);
+            reflect_naive_filter(input_image,reflect_naive_image);
+            
+            pandora::image8u reflect_fft_image(image_width,image_height,1,1,0);
+            pandora::gaussian_fft_border_filter<pandora::filter::border_reflect101> reflect_fft_filter(image_width,image_height,kernel_diameter,sigma);
+            reflect_fft_filter(input_image,reflect_fft_image);
+            
+            THEN("the blurred images should be close to the naive filter")
+            {
+                auto is_close = [](auto a, auto b)
+                {
+                    return std::abs(a-b) <=1;
+                };
+                
+                REQUIRE(std::equal(naive_image.begin(), naive_image.end(), fft_image.begin(), is_close));
+                REQUIRE(std::equal(reflect_naive_image.begin(), reflect_naive_image.end(), reflect_fft_image.begin(), is_close));
+            }
+        }
+    }
+    
+    GIVEN("Noisy images narrower than a strip of the column transforms")
+    {
+        std::default_random_engine generator;
+        std::uniform_int_distribution<int> dist(0,255);
+        
+        constexpr int image_height = 13;
+        
+        WHEN("apply the gaussian blur in the frequency domain on 1 to 8 pixels wide images")
+        {
+            THEN("the blurred images should be close to the separable filter")
+            {
+                for (int kernel_diameter : {3,5})
+                {
+                    for (int image_width = 1; image_width <= 8; ++image_width)
+                    {
+                        pandora::image8u input_image(image_width,image_height,1,1,0);
+                        for (auto& pixel_value : input_image)
+                        {
+                            pixel_value = static_cast<pandora::image8u::value_type>(dist(generator));
+                        }
+                        
+                        pandora::image8u separable_image(image_width,image_height,1,1,0);
+                        pandora::gaussian_separable_filter(image_width,image_height,kernel_diameter,1.f)(input_image,separable_image);
+                        
+                        pandora::image8u fft_image(image_width,image_height,1,1,0);
+                        pandora::gaussian_fft_filter(image_width,image_height,kernel_diameter,1.f)(input_image,fft_image);
+                        
+                        for (int y = 0; y < image_height; ++y)
+                        {
+                            for (int x = 0; x < image_width; ++x)
+                            {
+                                if (std::abs(fft_image(x,y) - separable_image(x,y)) > 1)
+                                {
+                                    FAIL("kernel " << kernel_diameter << " width " << image_width << " pixel " << x << "," << y);
+                                }
+                            }
+                        }
+                    }
+                }
+            }
+        }
+    }
+}
+
+SCENARIO("streaming gaussian filter", "[gaussian][filter][stream]")
+{
+    GIVEN("A grayscale noisy image pushed strip by strip")
+    {
+        constexpr int image_width = 333;
+        constexpr int image_height = 241;
+        
+        pandora::image8u input_image(image_width,image_height,1,1,0);
+        
+        std::default_random_engine generator;
+        std::uniform_int_distribution<int> dist(0,255);
+        for (auto& pixel_value : input_image)
+        {
+            pixel_value = static_cast<pandora::image8u::value_type>(dist(generator));
+        }
+        
+        constexpr int kernel_diameter = 9;
+        constexpr float sigma = 3.f;
+        
+        WHEN("stream the image through the filter")
+        {
+            pandora::image8u streamed_image(image_width,image_height,1,1,0);
+            int emitted_rows = 0;
+            
+            pandora::filter::gaussian_stream stream(image_width,kernel_diameter,sigma,
+                [&](int y, const pandora::image8u::value_type* row)
+                {
+                    std::copy(row,row+image_width,streamed_image.data(0,y));
+                    ++emitted_rows;
+                });
+            
+            for (int y = 0; y < image_height; y += 17)
+            {
+                stream.push_rows(input_image.get_rows(y,std::min(y+16,image_height-1)));
+            }
+            stream.finish();
+            
+            THEN("the blurred image should be identical to the separable filter")
+            {
+                pandora::image8u output_image(image_width,image_height,1,1,0);
+                pandora::gaussian_separable_filter separable_filter(image_width,image_height,kernel_diameter,sigma);
+                separable_filter(input_image,output_image);
+                
+                REQUIRE(emitted_rows == image_height);
+                REQUIRE(streamed_image == output_image);
+            }
+        }
+    }
+}
+
+SCENARIO("auto tuned gaussian filter", "[gaussian][filter][planner]")
+{
+    GIVEN("A grayscale noisy image and a planner")
+    {
+        constexpr int image_width = 160;
+        constexpr int image_height = 120;
+        
+        pandora::image8u input_image(image_width,image_height,1,1,0);
+        
+        std::default_random_engine generator;
+        std::uniform_int_distribution<int> dist(0,255);
+        for (auto& pixel_value : input_image)
+        {
+            pixel_value = static_cast<pandora::image8u::value_type>(dist(generator));
+        }
+        
+        constexpr int kernel_diameter = 7;
+        constexpr float sigma = 2.f;
+        
+        pandora::filter::gaussian_planner planner;
+        
+        WHEN("filter the image with the planned implementation")
+        {
+            pandora::image8u output_image(image_width,image_height,1,1,0);
+            pandora::gaussian_auto_filter auto_filter(planner,image_width,image_height,kernel_diameter,sigma);
+            auto_filter(input_image,output_image);
+            
+            THEN("the plan is cached and the blurred image should be identical to the separable filter")
+            {
+                REQUIRE(planner.size() == 1);
+                REQUIRE(planner.plan(image_width,image_height,kernel_diameter,sigma) == auto_filter.implementation());
+                REQUIRE(planner.size() == 1);
+                
+                pandora::image8u separable_image(image_width,image_height,1,1,0);
+                pandora::gaussian_separable_filter separable_filter(image_width,image_height,kernel_diameter,sigma);
+                separable_filter(input_image,separable_image);
+                REQUIRE(output_image == separable_image);
+            }
+        }
+        
+        WHEN("save the plans to a wisdom file and load them in another planner")
+        {
+            const auto engine = planner.plan(image_width,image_height,kernel_diameter,sigma);
+            const std::string wisdom_path = "gaussian_planner_test.wisdom";
+            REQUIRE(planner.save_wisdom(wisdom_path));
+            
+            pandora::filter::gaussian_planner loaded_planner;
+            const bool loaded = loaded_planner.load_wisdom(wisdom_path);
+            std::remove(wisdom_path.c_str());
+            
+            THEN("the other planner knows the plan")
+            {
+                REQUIRE(loaded);
+                REQUIRE(loaded_planner.size() == 1);
+                REQUIRE(loaded_planner.plan(image_width,image_height,kernel_diameter,sigma) == engine);
+            }
+        }
+    }
+}
+
+SCENARIO("gaussian filter on 16 bit and floating point images", "[gaussian][filter][pixel]")
+{
+    GIVEN("Noisy images of 16 bit and floating point pixels whose width is not a multiple of the vector size")
+    {
+        constexpr int image_width = 333;
+        constexpr int image_height = 241;
+        
+        std::default_random_engine generator;
+        
+        pandora::image16u input16_image(image_width,image_height,1,1,0);
+        std::uniform_int_distribution<int> dist16(0,65535);
+        for (auto& pixel_value : input16_image)
+        {
+            pixel_value = static_cast<pandora::image16u::value_type>(dist16(generator));
+        }
+        
+        pandora::image32f input32_image(image_width,image_height,1,1,0);
+        std::uniform_real_distribution<float> dist32(0.f,1.f);
+        for (auto& pixel_value : input32_image)
+        {
+            pixel_value = dist32(generator);
+        }
+        
+        WHEN("apply the gaussian blur with each implementation")
+        {
+            THEN("the blurred images should be close to the naive filter, the vectorized paths identical to the scalar one")
+            {
+                //tolerance : the rounding for the exact filters, the single precision arithmetic for the frequency
+                //domain filter, 2 grey levels of the range for the approximations (recursive and box filters)
+                auto check = [&](const auto &input_image,double exact_tolerance,double fft_tolerance,double approximation_tolerance)
+                {
+                    using image_type = typename std::decay<decltype(input_image)>::type;
+                    using pixel_type = typename image_type::value_type;
+                    
+                    auto is_close = [](const image_type &a,const image_type &b,double tolerance)
+                    {
+                        return std::equal(a.begin(), a.end(), b.begin(), [tolerance](pixel_type u, pixel_type v)
+                        {
+                            return std::abs(static_cast<double>(u)-static_cast<double>(v)) <= tolerance;
+                        });
+                    };
+                    
+                    for (int kernel_diameter : {5,15})
+                    {
+                        constexpr float sigma = 3.f;
+                        
+                        image_type naive_image(image_width,image_height,1,1,0);
+                        pandora::basic_gaussian_naive_filter<pixel_type> naive_filter(kernel_diameter,sigma);
+                        naive_filter(input_image,naive_image);
+                        
+                        image_type scalar_image(image_width,image_height,1,1,0);
+                        pandora::filter::details::gaussian_separable_impl<pixel_type> scalar_filter(image_width,image_height,kernel_diameter,sigma);
+                        scalar_filter.apply(input_image,scalar_image);
+                        REQUIRE(is_close(naive_image,scalar_image,exact_tolerance));
+                        
+                        for (auto level : {pandora::simd_level::scalar,pandora::simd_level::sse41,pandora::simd_level::avx2})
+                        {
+                            image_type simd_image(image_width,image_height,1,1,0);
+                            pandora::filter::details::gaussian_simd_impl<pixel_type> simd_filter(image_width,image_height,kernel_diameter,sigma,level);
+                            simd_filter.apply(input_image,simd_image);
+                            REQUIRE(simd_image == scalar_image);
+                        }
+                    }
+                    
+                    constexpr int kernel_diameter = 31;
+                    constexpr float sigma = 5.f;
+                    
+                    image_type naive_image(image_width,image_height,1,1,0);
+                    pandora::basic_gaussian_naive_filter<pixel_type> naive_filter(kernel_diameter,sigma);
+                    naive_filter(input_image,naive_image);
+                    
+                    image_type fft_image(image_width,image_height,1,1,0);
+                    pandora::basic_gaussian_fft_filter<pixel_type> fft_filter(image_width,image_height,kernel_diameter,sigma);
+                    fft_filter(input_image,fft_image);
+                    REQUIRE(is_close(naive_image,fft_image,fft_tolerance));
+                    
+                    image_type recursive_image(image_width,image_height,1,1,0);
+                    pandora::basic_gaussian_recursive_filter<pixel_type> recursive_filter(image_width,image_height,kernel_diameter,sigma);
+                    recursive_filter(input_image,recursive_image);
+                    REQUIRE(is_close(naive_image,recursive_image,approximation_tolerance));
+                    
+                    image_type box_image(image_width,image_height,1,1,0);
+                    pandora::basic_gaussian_box_filter<pixel_type> box_filter(image_width,image_height,kernel_diameter,sigma);
+                    box_filter(input_image,box_image);
+                    REQUIRE(is_close(naive_image,box_image,approximation_tolerance));
+                };
+                
+                check(input16_image,1.0,1.0,2*257.0);
+                check(input32_image,1e-5,1e-5,2/255.0);
+            }
+        }
+    }
+}
+
+SCENARIO("gaussian filter on colour images", "[gaussian][filter][channel]")
+{
+    GIVEN("Noisy colour images, planar and interleaved, wide enough to be tiled in columns")
+    {
+        std::default_random_engine generator;
+        std::uniform_int_distribution<int> dist(0,255);
+        
+        WHEN("apply the gaussian blur on every channel at once")
+        {
+            THEN("the blurred channels should be identical to the channels blurred one by one")
+            {
+                auto check = [&](auto &filter,int width,int height,int channel_count,int kernel_diameter,float sigma)
+                {
+                    pandora::image8u planar_image(width,height,1,channel_count,0);
+                    for (auto& pixel_value : planar_image)
+                    {
+                        pixel_value = static_cast<pandora::image8u::value_type>(dist(generator));
+                    }
+                    
+                    //reference : one call per channel
+                    pandora::image8u channel_image(width,height,1,1,0);
+                    pandora::image8u reference_image(width,height,1,channel_count,0);
+                    for (int c = 0; c < channel_count; ++c)
+                    {
+                        pandora::gaussian_separable_filter channel_filter(width,height,kernel_diameter,sigma);
+                        channel_filter(planar_image.get_channel(c),channel_image);
+                        reference_image.draw_image(0,0,0,c,channel_image);
+                    }
+                    
+                    pandora::image8u planar_output(width,height,1,channel_count,0);
+                    filter(planar_image,planar_output);
+                    REQUIRE(planar_output == reference_image);
+                    
+                    //the same pixels, interleaved
+                    pandora::image8u interleaved_image(width*channel_count,height,1,1,0);
+                    pandora::image8u interleaved_reference(width*channel_count,height,1,1,0);
+                    for (int y = 0; y < height; ++y)
+                    {
+                        for (int x = 0; x < width; ++x)
+                        {
+                            for (int c = 0; c < channel_count; ++c)
+                            {
+                                interleaved_image(x*channel_count+c,y) = planar_image(x,y,0,c);
+                                interleaved_reference(x*channel_count+c,y) = reference_image(x,y,0,c);
+                            }
+                        }
+                    }
+                    
+                    pandora::image8u interleaved_output(width*channel_count,height,1,1,0);
+                    filter.interleaved(interleaved_image,interleaved_output,channel_count);
+                    REQUIRE(interleaved_output == interleaved_reference);
+                };
+                
+                for (int channel_count : {3,4})
+                {
+                    pandora::gaussian_separable_filter separable_filter(133,71,11,2.f);
+                    check(separable_filter,133,71,channel_count,11,2.f);
+                    
+                    pandora::gaussian_simd_filter simd_filter(133,71,7,2.f);
+                    check(simd_filter,133,71,channel_count,7,2.f);
+                    
+                    pandora::gaussian_simd_filter tiled_filter(1301,37,41,7.f);
+                    check(tiled_filter,1301,37,channel_count,41,7.f);
+                }
+            }
+            
+            THEN("the implementations without interleaved pass should filter a planar copy")
+            {
+                constexpr int width = 97;
+                constexpr int height = 53;
+                constexpr int channel_count = 3;
+                
+                pandora::image8u interleaved_image(width*channel_count,height,1,1,0);
+                for (auto& pixel_value : interleaved_image)
+                {
+                    pixel_value = static_cast<pandora::image8u::value_type>(dist(generator));
+                }
+                
+                pandora::image8u naive_image(width*channel_count,height,1,1,0);
+                pandora::gaussian_naive_filter naive_filter(9,2.f);
+                naive_filter.interleaved(interleaved_image,naive_image,channel_count);
+                
+                pandora::image8u simd_image(width*channel_count,height,1,1,0);
+                pandora::gaussian_simd_filter simd_filter(width,height,9,2.f);
+                simd_filter.interleaved(interleaved_image,simd_image,channel_count);
+                
+                bool are_close = std::equal(naive_image.begin(), naive_image.end(), simd_image.begin(),
+                [](auto a, auto b)
+                {
+                    return std::abs(a-b) <=1;
+                });
+                REQUIRE(are_close == true);
+            }
+        }
+    }
+}
+
+SCENARIO("batch of gaussian filtered images", "[gaussian][filter][batch]")
+{
+    GIVEN("A batch of noisy images of different sizes and a thread pool")
+    {
+        std::default_random_engine generator;
+        std::uniform_int_distribution<int> dist(0,255);
+        
+        const int sizes[][2] = {{64,48},{333,241},{17,9},{160,120},{400,31},{96,96},{5,4},{200,150}};
+        std::vector<pandora::image8u> input_images;
+        for (int i = 0; i < 24; ++i)
+        {
+            input_images.emplace_back(sizes[i % 8][0],sizes[i % 8][1],1,1,0);
+            for (auto& pixel_value : input_images.back())
+            {
+                pixel_value = static_cast<pandora::image8u::value_type>(dist(generator));
+            }
+        }
+        
+        pandora::thread_pool pool(4);
+        
+        constexpr int kernel_diameter = 9;
+        constexpr float sigma = 2.f;
+        
+        WHEN("apply the gaussian blur on the whole batch")
+        {
+            THEN("each blurred image should be identical to the one of a filter constructed for its size")
+            {
+                auto check = [&](auto &&filter,auto make_filter)
+                {
+                    std::vector<pandora::image8u> output_images;
+                    std::vector<pandora::image8u> threaded_images;
+                    for (const auto& image : input_images)
+                    {
+                        output_images.emplace_back(image.width(),image.height(),1,1,0);
+                        threaded_images.emplace_back(image.width(),image.height(),1,1,0);
+                    }
+                    
+                    std::vector<std::pair<const pandora::image8u*,pandora::image8u*>> pairs;
+                    std::vector<std::pair<const pandora::image8u*,pandora::image8u*>> threaded_pairs;
+                    for (std::size_t i = 0; i < input_images.size(); ++i)
+                    {
+                        pairs.emplace_back(&input_images[i],&output_images[i]);
+                        threaded_pairs.emplace_back(&input_images[i],&threaded_images[i]);
+                    }
+                    
+                    filter.batch(pairs.data(),static_cast<int>(pairs.size()));
+                    filter.batch(threaded_pairs.data(),static_cast<int>(threaded_pairs.size()),pool);
+                    
+                    for (std::size_t i = 0; i < input_images.size(); ++i)
+                    {
+                        const auto& image = input_images[i];
+                        pandora::image8u reference_image(image.width(),image.height(),1,1,0);
+                        auto reference_filter = make_filter(image.width(),image.height());
+                        reference_filter(image,reference_image);
+                        
+                        REQUIRE(output_images[i] == reference_image);
+                        REQUIRE(threaded_images[i] == reference_image);
+                    }
+                };
+                
+                check(pandora::gaussian_separable_filter(32,32,kernel_diameter,sigma),[&](int width,int height)
+                {
+                    return pandora::gaussian_separable_filter(width,height,kernel_diameter,sigma);
+                });
+                check(pandora::gaussian_simd_filter(32,32,kernel_diameter,sigma),[&](int width,int height)
+                {
+                    return pandora::gaussian_simd_filter(width,height,kernel_diameter,sigma);
+                });
+                check(pandora::gaussian_recursive_filter(32,32,kernel_diameter,sigma),[&](int width,int height)
+                {
+                    return pandora::gaussian_recursive_filter(width,height,kernel_diameter,sigma);
+                });
+                check(pandora::gaussian_box_filter<3>(32,32,kernel_diameter,sigma),[&](int width,int height)
+                {
+                    return pandora::gaussian_box_filter<3>(width,height,kernel_diameter,sigma);
+                });
+            }
+        }
+    }
+}
+
+SCENARIO("gaussian filter reused across resolutions", "[gaussian][filter][resolution]")
+{
+    GIVEN("Noisy images of growing and shrinking sizes, one wide enough to be tiled in columns")
+    {
+        std::default_random_engine generator;
+        std::uniform_int_distribution<int> dist(0,255);
+        
+        const int sizes[][2] = {{64,48},{1301,37},{17,9},{333,241},{5,4},{1301,37},{640,8},{64,48}};
+        
+        constexpr int kernel_diameter = 41;
+        constexpr float sigma = 7.f;
+        
+        WHEN("apply the gaussian blur with a single filter instance, constructed without image size")
+        {
+            pandora::gaussian_separable_filter separable_filter(0,0,kernel_diameter,sigma);
+            pandora::gaussian_simd_filter simd_filter(0,0,kernel_diameter,sigma);
+            pandora::basic_gaussian_simd_filter<float> float_filter(0,0,kernel_diameter,sigma);
+            pandora::thread_pool pool(3);
+            
+            THEN("the blurred images should be identical to the ones of filters constructed for their size")
+            {
+                for (const auto& size : sizes)
+                {
+                    const int width = size[0];
+                    const int height = size[1];
+                    
+                    pandora::image8u input_image(width,height,1,1,0);
+                    for (auto& pixel_value : input_image)
+                    {
+                        pixel_value = static_cast<pandora::image8u::value_type>(dist(generator));
+                    }
+                    
+                    pandora::image8u reference_image(width,height,1,1,0);
+                    pandora::gaussian_separable_filter reference_filter(width,height,kernel_diameter,sigma);
+                    reference_filter(input_image,reference_image);
+                    
+                    pandora::image8u output_image(width,height,1,1,0);
+                    separable_filter(input_image,output_image);
+                    REQUIRE(output_image == reference_image);
+                    
+                    output_image.fill(0);
+                    simd_filter(input_image,output_image,pool);
+                    REQUIRE(output_image == reference_image);
+                    
+                    pandora::image32f float_input(input_image);
+                    pandora::image32f float_reference(width,height,1,1,0);
+                    pandora::basic_gaussian_simd_filter<float> float_reference_filter(width,height,kernel_diameter,sigma);
+                    float_reference_filter(float_input,float_reference);
+                    
+                    pandora::image32f float_output(width,height,1,1,0);
+                    float_filter(float_input,float_output);
+                    REQUIRE(float_output == float_reference);
+                }
+            }
+        }
+    }
+}
+
+SCENARIO("gaussian filter on regions of interest", "[gaussian][filter][region]")
+{
+    GIVEN("A noisy image and overlapping regions, one of them crossing the image border, two of them not aligned")
+    {
+        std::default_random_engine generator;
+        std::uniform_int_distribution<int> dist(0,255);
+        
+        constexpr int width = 1301;
+        constexpr int height = 97;
+        pandora::image8u input_image(width,height,1,2,0);
+        for (auto& pixel_value : input_image)
+        {
+            pixel_value = static_cast<pandora::image8u::value_type>(dist(generator));
+        }
+        
+        const std::vector<pandora::region> regions = {{10,5,300,40},{200,20,900,30},{250,25,50,10},{1200,60,200,80},{5,80,20,10},{400,0,2,2},{20,50,10,10},{29,50,10,9}};
+        constexpr int kernel_diameter = 41;
+        constexpr float sigma = 7.f;
+        constexpr pandora::image8u::value_type untouched = 7;
+        
+        auto inside = [&](int x,int y)
+        {
+            return std::any_of(regions.begin(),regions.end(),[&](const pandora::region &r)
+            {
+                return x >= r.x && x < r.x + r.width && y >= r.y && y < r.y + r.height;
+            });
+        };
+        
+        auto check = [&](const pandora::image8u &reference_image,const pandora::image8u &output_image)
+        {
+            for (int c = 0; c < input_image.spectrum(); ++c)
+            {
+                for (int y = 0; y < height; ++y)
+                {
+                    for (int x = 0; x < width; ++x)
+                    {
+                        const auto expected = inside(x,y) ? reference_image(x,y,0,c) : untouched;
+                        if (output_image(x,y,0,c) != expected)
+                        {
+                            FAIL("pixel " << x << "," << y << "," << c << " : " << +output_image(x,y,0,c) << " instead of " << +expected);
+                        }
+                    }
+                }
+            }
+        };
+        
+        WHEN("turn the regions into disjoint regions")
+        {
+            const auto areas = pandora::disjoint_regions(regions,pandora::region{0,0,width,height});
+            
+            THEN("the disjoint regions should cover the pixels of the regions inside the image once")
+            {
+                pandora::image<int> coverage(width,height,1,1,0);
+                for (const auto& area : areas)
+                {
+                    for (int y = area.y; y < area.y + area.height; ++y)
+                    {
+                        for (int x = area.x; x < area.x + area.width; ++x)
+                        {
+                            ++coverage(x,y);
+                        }
+                    }
+                }
+                for (int y = 0; y < height; ++y)
+                {
+                    for (int x = 0; x < width; ++x)
+                    {
+                        REQUIRE(coverage(x,y) == (inside(x,y) ? 1 : 0));
+                    }
+                }
+            }
+        }
+        
+        WHEN("apply the gaussian blur on the regions only")
+        {
+            THEN("the regions should be identical to the blurred image, the other pixels untouched")
+            {
+                pandora::thread_pool pool(3);
+                
+                auto run = [&](auto &&filter,bool parallel)
+                {
+                    pandora::image8u reference_image(width,height,1,2,0);
+                    filter(input_image,reference_image);
+                    
+                    pandora::image8u output_image(width,height,1,2,untouched);
+                    if (parallel)
+                    {
+                        filter(input_image,output_image,regions,pool);
+                    }
+                    else
+                    {
+                        filter(input_image,output_image,regions);
+                    }
+                    check(reference_image,output_image);
+                };
+                
+                run(pandora::gaussian_separable_filter(width,height,kernel_diameter,sigma),false);
+                run(pandora::gaussian_simd_filter(width,height,kernel_diameter,sigma),true);
+                run(pandora::gaussian_simd_border_filter<pandora::filter::border_reflect101>(width,height,kernel_diameter,sigma),false);
+                run(pandora::gaussian_naive_filter(kernel_diameter,sigma),true);
+                run(pandora::gaussian_recursive_filter(width,height,kernel_diameter,sigma),false);
+            }
+        }
+        
+        WHEN("apply the gaussian blur on the regions of a floating point image, processed in tiles of columns")
+        {
+            pandora::image32f float_input(input_image);
+            pandora::basic_gaussian_simd_filter<float> filter(width,height,kernel_diameter,sigma);
+            
+            pandora::image32f reference_image(width,height,1,2,0);
+            filter(float_input,reference_image);
+            
+            pandora::image32f output_image(width,height,1,2,untouched);
+            filter(float_input,output_image,regions);
+            
+            THEN("the regions should be identical to the blurred image, the other pixels untouched")
+            {
+                for (int c = 0; c < 2; ++c)
+                {
+                    for (int y = 0; y < height; ++y)
+                    {
+                        for (int x = 0; x < width; ++x)
+                        {
+                            REQUIRE(output_image(x,y,0,c) == (inside(x,y) ? reference_image(x,y,0,c) : float(untouched)));
+                        }
+                    }
+                }
+            }
+        }
+    }
+}
+
+SCENARIO("incremental gaussian filter on dirty regions", "[gaussian][filter][incremental]")
+{
+    GIVEN("A noisy canvas whose regions are painted frame after frame, along the borders too")
+    {
+        std::default_random_engine generator;
+        std::uniform_int_distribution<int> dist(0,255);
+        
+        constexpr int width = 320;
+        constexpr int height = 120;
+        constexpr int kernel_diameter = 15;
+        constexpr float sigma = 3.f;
+        
+        const std::vector<std::vector<pandora::region>> frames = {
+            {{100,50,20,10}},
+            {{0,0,5,3},{310,115,40,40}},
+            {{30,40,50,50},{60,60,30,5},{200,0,1,120}},
+            {},
+            {{-10,110,400,20}}};
+        
+        auto run = [&](auto &&incremental_filter,auto &&reference_filter,auto &input_image)
+        {
+            using image_type = typename std::decay<decltype(input_image)>::type;
+            using value_type = typename image_type::value_type;
+            
+            for (auto& pixel_value : input_image)
+            {
+                pixel_value = static_cast<value_type>(dist(generator));
+            }
+            image_type reference_image(width,height,1,input_image.spectrum(),0);
+            reference_filter(input_image,reference_image);
+            REQUIRE(incremental_filter.apply(input_image) == reference_image);
+            
+            for (const auto& dirty_regions : frames)
+            {
+                for (const auto& dirty : dirty_regions)
+                {
+                    const auto area = pandora::intersection(dirty,pandora::region{0,0,width,height});
+                    for (int c = 0; c < input_image.spectrum(); ++c)
+                    {
+                        for (int y = area.y; y < area.y + area.height; ++y)
+                        {
+                            for (int x = area.x; x < area.x + area.width; ++x)
+                            {
+                                input_image(x,y,0,c) = static_cast<value_type>(dist(generator));
+                            }
+                        }
+                    }
+                }
+                
+                reference_filter(input_image,reference_image);
+                REQUIRE(incremental_filter.update(input_image,dirty_regions) == reference_image);
+            }
+        };
+        
+        WHEN("update the blurred canvas with the dirty regions only")
+        {
+            THEN("each frame should be identical to the blurred canvas")
+            {
+                pandora::image8u input_image(width,height,1,2,0);
+                run(pandora::filter::gaussian_incremental<>(kernel_diameter,sigma),
+                    pandora::gaussian_simd_filter(width,height,kernel_diameter,sigma),input_image);
+                run(pandora::filter::gaussian_incremental<>(7,1.5f),
+                    pandora::gaussian_separable_filter(width,height,7,1.5f),input_image);
+                run(pandora::filter::gaussian_incremental<uint8_t,pandora::filter::border_reflect101>(kernel_diameter,sigma),
+                    pandora::gaussian_simd_border_filter<pandora::filter::border_reflect101>(width,height,kernel_diameter,sigma),input_image);
+                run(pandora::filter::gaussian_incremental<uint8_t,pandora::filter::border_wrap>(kernel_diameter,sigma),
+                    pandora::gaussian_simd_border_filter<pandora::filter::border_wrap>(width,height,kernel_diameter,sigma),input_image);
+                run(pandora::filter::gaussian_incremental<uint8_t,pandora::filter::border_constant<100>>(kernel_diameter,sigma),
+                    pandora::gaussian_simd_border_filter<pandora::filter::border_constant<100>>(width,height,kernel_diameter,sigma),input_image);
+                
+                pandora::image32f float_image(width,height,1,1,0);
+                run(pandora::filter::gaussian_incremental<float>(kernel_diameter,sigma),
+                    pandora::basic_gaussian_simd_filter<float>(width,height,kernel_diameter,sigma),float_image);
+            }
+        }
+    }
+}
+
+SCENARIO("anisotropic gaussian filter", "[gaussian][filter][anisotropic]")
+{
+    GIVEN("A noisy image")
+    {
+        std::default_random_engine generator;
+        std::uniform_int_distribution<int> dist(0,255);
+        
+        constexpr int width = 211;
+        constexpr int height = 67;
+        pandora::image8u input_image(width,height,1,1,0);
+        for (auto& pixel_value : input_image)
+        {
+            pixel_value = static_cast<pandora::image8u::value_type>(dist(generator));
+        }
+        
+        const int kernel_sizes[][2] = {{21,5},{3,15},{5,7},{1,9},{9,1}};
+        
+        WHEN("apply an anisotropic gaussian blur on floating point pixels")
+        {
+            THEN("the blurred image should be identical to a horizontal blur followed by a vertical blur")
+            {
+                pandora::image32f float_input(input_image);
+                for (const auto& sizes : kernel_sizes)
+                {
+                    const float sigma_x = sizes[0] / 4.f;
+                    const float sigma_y = sizes[1] / 4.f;
+                    
+                    pandora::basic_gaussian_simd_filter<float> horizontal_filter(width,height,sizes[0],sigma_x,1,1.f);
+                    pandora::basic_gaussian_simd_filter<float> vertical_filter(width,height,1,1.f,sizes[1],sigma_y);
+                    pandora::image32f horizontal_image(width,height,1,1,0);
+                    pandora::image32f reference_image(width,height,1,1,0);
+                    horizontal_filter(float_input,horizontal_image);
+                    vertical_filter(horizontal_image,reference_image);
+                    
+                    pandora::basic_gaussian_simd_filter<float> filter(width,height,sizes[0],sigma_x,sizes[1],sigma_y);
+                    pandora::image32f output_image(width,height,1,1,0);
+                    filter(float_input,output_image);
+                    REQUIRE(output_image == reference_image);
+                }
+            }
+        }
+        
+        WHEN("apply an anisotropic gaussian blur on 8 bit pixels")
+        {
+            THEN("all the implementations should give the same image, within the Q8 rounding of the floating point one")
+            {
+                for (const auto& sizes : kernel_sizes)
+                {
+                    const float sigma_x = sizes[0] / 4.f;
+                    const float sigma_y = sizes[1] / 4.f;
+                    
+                    pandora::image8u reference_image(width,height,1,1,0);
+                    pandora::gaussian_separable_filter separable_filter(width,height,sizes[0],sigma_x,sizes[1],sigma_y);
+                    separable_filter(input_image,reference_image);
+                    
+                    pandora::image8u output_image(width,height,1,1,0);
+                    pandora::gaussian_simd_filter simd_filter(width,height,sizes[0],sigma_x,sizes[1],sigma_y);
+                    simd_filter(input_image,output_image);
+                    REQUIRE(output_image == reference_image);
+                    
+                    pandora::thread_pool pool(2);
+                    output_image.fill(0);
+                    simd_filter(input_image,output_image,pool);
+                    REQUIRE(output_image == reference_image);
+                    
+                    pandora::image32f float_input(input_image);
+                    pandora::image32f float_output(width,height,1,1,0);
+                    pandora::basic_gaussian_simd_filter<float> float_filter(width,height,sizes[0],sigma_x,sizes[1],sigma_y);
+                    float_filter(float_input,float_output);
+                    for (int y = 0; y < height; ++y)
+                    {
+                        for (int x = 0; x < width; ++x)
+                        {
+                            REQUIRE(std::abs(reference_image(x,y) - float_output(x,y)) <= 2.f);
+                        }
+                    }
+                }
+            }
+        }
+        
+        WHEN("apply an anisotropic gaussian blur with the same parameters on both axes")
+        {
+            pandora::gaussian_simd_filter isotropic_filter(width,height,7,1.5f);
+            pandora::gaussian_simd_filter anisotropic_filter(width,height,7,1.5f,7,1.5f);
+            pandora::image8u isotropic_image(width,height,1,1,0);
+            pandora::image8u anisotropic_image(width,height,1,1,0);
+            isotropic_filter(input_image,isotropic_image);
+            anisotropic_filter(input_image,anisotropic_image);
+            
+            THEN("the blurred image should be identical to the isotropic one")
+            {
+                REQUIRE(anisotropic_image == isotropic_image);
+            }
+        }
+    }
+}
+
+SCENARIO("fused gaussian derivatives", "[gaussian][filter][derivative]")
+{
+    GIVEN("A noisy image and polynomial images of known derivatives")
+    {
+        std::default_random_engine generator;
+        std::uniform_int_distribution<int> dist(0,255);
+        
+        constexpr int width = 157;
+        constexpr int height = 43;
+        constexpr int kernel_diameter = 13;
+        constexpr float sigma = 2.5f;
+        
+        pandora::image8u input_image(width,height,1,2,0);
+        for (auto& pixel_value : input_image)
+        {
+            pixel_value = static_cast<pandora::image8u::value_type>(dist(generator));
+        }
+        
+        pandora::image32f dx(width,height,1,2,0), dy(width,height,1,2,0), dxx(width,height,1,2,0), dyy(width,height,1,2,0), dxy(width,height,1,2,0);
+        
+        WHEN("compute all the derivatives in a single traversal")
+        {
+            pandora::filter::gaussian_derivatives<> derivatives(kernel_diameter,sigma);
+            derivatives.apply(input_image,{&dx,&dy,&dxx,&dyy,&dxy});
+            
+            THEN("each derivative should be the 2D correlation with the product of the 1D derivative kernels")
+            {
+                const int kernel_radius = kernel_diameter/2;
+                const pandora::filter::details::gaussian_derivative_kernel kernels[] = {{kernel_diameter,sigma,0},{kernel_diameter,sigma,1},{kernel_diameter,sigma,2}};
+                
+                auto reference = [&](int x,int y,int c,int order_x,int order_y)
+                {
+                    double sum = 0;
+                    for (int j = -kernel_radius; j <= kernel_radius; ++j)
+                    {
+                        for (int i = -kernel_radius; i <= kernel_radius; ++i)
+                        {
+                            const int xi = pandora::filter::border_clamp::index(x+i,width);
+                            const int yj = pandora::filter::border_clamp::index(y+j,height);
+                            sum += static_cast<double>(kernels[order_x][i])*kernels[order_y][j]*input_image(xi,yj,0,c);
+                        }
+                    }
+                    return sum;
+                };
+                
+                for (int c = 0; c < 2; ++c)
+                {
+                    for (int y = 0; y < height; ++y)
+                    {
+                        for (int x = 0; x < width; ++x)
+                        {
+                            REQUIRE(dx(x,y,0,c) == Approx(reference(x,y,c,1,0)).margin(1e-3));
+                            REQUIRE(dy(x,y,0,c) == Approx(reference(x,y,c,0,1)).margin(1e-3));
+                            REQUIRE(dxx(x,y,0,c) == Approx(reference(x,y,c,2,0)).margin(1e-3));
+                            REQUIRE(dyy(x,y,0,c) == Approx(reference(x,y,c,0,2)).margin(1e-3));
+                            REQUIRE(dxy(x,y,0,c) == Approx(reference(x,y,c,1,1)).margin(1e-3));
+                        }
+                    }
+                }
+            }
+            
+            THEN("the derivatives should not depend on the instruction set nor on the other outputs requested")
+            {
+                pandora::filter::gaussian_derivatives<> scalar_derivatives(kernel_diameter,sigma,pandora::simd_level::scalar);
+                pandora::image32f scalar_dx(width,height,1,2,0), scalar_dyy(width,height,1,2,0);
+                scalar_derivatives.apply(input_image,{&scalar_dx,nullptr,nullptr,&scalar_dyy,nullptr});
+                
+                REQUIRE(scalar_dx == dx);
+                REQUIRE(scalar_dyy == dyy);
+            }
+        }
+        
+        WHEN("compute the derivatives of the polynomial images x, y, x2/2, y2/2 and xy")
+        {
+            pandora::image32f ramp_x(width,height,1,1,0), ramp_y(width,height,1,1,0), square_x(width,height,1,1,0), square_y(width,height,1,1,0), product(width,height,1,1,0);
+            for (int y = 0; y < height; ++y)
+            {
+                for (int x = 0; x < width; ++x)
+                {
+                    ramp_x(x,y) = static_cast<float>(x);
+                    ramp_y(x,y) = static_cast<float>(y);
+                    square_x(x,y) = x*x/2.f;
+                    square_y(x,y) = y*y/2.f;
+                    product(x,y) = static_cast<float>(x*y);
+                }
+            }
+            
+            using derivative_images = pandora::filter::gaussian_derivatives<float>::derivative_images;
+            pandora::filter::gaussian_derivatives<float> derivatives(kernel_diameter,sigma);
+            pandora::image32f output(width,height,1,1,0);
+            
+            THEN("the derivatives should be 1 away from the borders")
+            {
+                const int kernel_radius = kernel_diameter/2;
+                auto check = [&](const pandora::image32f &image,pandora::image32f* derivative_images::* member)
+                {
+                    derivative_images outputs;
+                    outputs.*member = &output;
+                    derivatives.apply(image,outputs);
+                    for (int y = kernel_radius; y < height - kernel_radius; ++y)
+                    {
+                        for (int x = kernel_radius; x < width - kernel_radius; ++x)
+                        {
+                            REQUIRE(output(x,y) == Approx(1.f).epsilon(1e-3));
+                        }
+                    }
+                };
+                
+                check(ramp_x,&derivative_images::dx);
+                check(ramp_y,&derivative_images::dy);
+                check(square_x,&derivative_images::dxx);
+                check(square_y,&derivative_images::dyy);
+                check(product,&derivative_images::dxy);
+            }
+        }
+    }
+}
+
+SCENARIO("gaussian pyramid", "[gaussian][filter][pyramid]")
+{
+    GIVEN("Noisy images of even and odd sizes")
+    {
+        std::default_random_engine generator;
+        std::uniform_int_distribution<int> dist(0,255);
+        
+        const int sizes[][2] = {{640,480},{333,97},{31,8},{640,480}};
+        constexpr int level_count = 5;
+        constexpr int kernel_diameter = 5;
+        constexpr float sigma = 1.f;
+        
+        WHEN("build the pyramids with a single pyramid instance")
+        {
+            pandora::pyramid pyramid(level_count,kernel_diameter,sigma);
+            pandora::pyramid parallel_pyramid(level_count,kernel_diameter,sigma);
+            pandora::basic_pyramid<float> float_pyramid(level_count,kernel_diameter,sigma);
+            pandora::thread_pool pool(3);
+            
+            THEN("each level should be the even pixels of the previous level blurred")
+            {
+                for (const auto& size : sizes)
+                {
+                    pandora::image8u input_image(size[0],size[1],1,2,0);
+                    for (auto& pixel_value : input_image)
+                    {
+                        pixel_value = static_cast<pandora::image8u::value_type>(dist(generator));
+                    }
+                    
+                    pyramid.build(input_image);
+                    parallel_pyramid.build(input_image,pool);
+                    float_pyramid.build(pandora::image32f(input_image));
+                    
+                    REQUIRE(pyramid.size() == level_count);
+                    REQUIRE(pyramid[0] == input_image);
+                    for (int i = 1; i < level_count; ++i)
+                    {
+                        const auto& previous = pyramid[i-1];
+                        pandora::image8u blurred_image(previous.width(),previous.height(),1,2,0);
+                        pandora::gaussian_simd_filter(previous.width(),previous.height(),kernel_diameter,sigma)(previous,blurred_image);
+                        
+                        const auto& level = pyramid[i];
+                        REQUIRE(level.width() == (previous.width()+1)/2);
+                        REQUIRE(level.height() == (previous.height()+1)/2);
+                        for (int c = 0; c < 2; ++c)
+                        {
+                            for (int y = 0; y < level.height(); ++y)
+                            {
+                                for (int x = 0; x < level.width(); ++x)
+                                {
+                                    if (level(x,y,0,c) != blurred_image(2*x,2*y,0,c))
+                                    {
+                                        FAIL("level " << i << " pixel " << x << "," << y << "," << c);
+                                    }
+                                }
+                            }
+                        }
+                        REQUIRE(parallel_pyramid[i] == level);
+                        
+                        //the float pyramid sums the even and odd taps apart : same image, up to the float rounding
+                        const auto& float_previous = float_pyramid[i-1];
+                        pandora::image32f float_blurred(float_previous.width(),float_previous.height(),1,2,0);
+                        pandora::basic_gaussian_simd_filter<float>(float_previous.width(),float_previous.height(),kernel_diameter,sigma)(float_previous,float_blurred);
+                        for (int c = 0; c < 2; ++c)
+                        {
+                            for (int y = 0; y < level.height(); ++y)
+                            {
+                                for (int x = 0; x < level.width(); ++x)
+                                {
+                                    REQUIRE(float_pyramid[i](x,y,0,c) == Approx(float_blurred(2*x,2*y,0,c)).margin(1e-3));
+                                }
+                            }
+                        }
+                    }
+                }
+            }
+        }
+    }
+}
+
+SCENARIO("gaussian scale space", "[gaussian][filter][scalespace]")
+{
+    GIVEN("A smooth noisy image")
+    {
+        std::default_random_engine generator;
+        std::uniform_int_distribution<int> dist(0,255);
+        
+        constexpr int image_width = 160;
+        constexpr int image_height = 120;
+        constexpr int level_count = 5;
+        constexpr float sigma = 1.6f;
+        const float scale_ratio = std::sqrt(2.f);
+        
+        pandora::image8u noise_image(image_width,image_height,1,1,0);
+        for (auto& pixel_value : noise_image)
+        {
+            pixel_value = static_cast<pandora::image8u::value_type>(dist(generator));
+        }
+        pandora::image32f input_image(image_width,image_height,1,1,0);
+        pandora::basic_gaussian_simd_filter<float>(image_width,image_height,7,1.f)(pandora::image32f(noise_image),input_image);
+        
+        WHEN("build the scale space")
+        {
+            pandora::scale_space scale_space(level_count,sigma,scale_ratio);
+            scale_space.build(input_image);
+            
+            THEN("each level should be the previous level blurred with the incremental sigma")
+            {
+                REQUIRE(scale_space.size() == level_count);
+                const pandora::image32f* previous = &input_image;
+                for (int i = 0; i < level_count; ++i)
+                {
+                    const auto& kernel = scale_space.get_kernel(i);
+                    pandora::image32f blurred_image(image_width,image_height,1,1,0);
+                    pandora::basic_gaussian_simd_filter<float>(image_width,image_height,kernel.size(),kernel.sigma())(*previous,blurred_image);
+                    
+                    REQUIRE(scale_space.level(i) == blurred_image);
+                    REQUIRE(scale_space.sigma(i) == Approx(sigma*std::pow(scale_ratio,i)));
+                    previous = &scale_space.level(i);
+                }
+            }
+            
+            THEN("the differences of gaussians should be the differences of consecutive levels")
+            {
+                for (int i = 0; i + 1 < level_count; ++i)
+                {
+                    pandora::image32f difference = scale_space.level(i+1);
+                    difference -= scale_space.level(i);
+                    REQUIRE(scale_space.difference(i) == difference);
+                }
+            }
+            
+            THEN("a scale space built without levels should have one level and no difference")
+            {
+                pandora::scale_space single_level(0,sigma,scale_ratio);
+                single_level.build(input_image);
+                REQUIRE(single_level.size() == 1);
+                REQUIRE(single_level.level(0) == scale_space.level(0));
+            }
+            
+            THEN("each level should be close to the image blurred directly with its sigma")
+            {
+                for (int i = 0; i < level_count; ++i)
+                {
+                    const float level_sigma = scale_space.sigma(i);
+                    const int kernel_diameter = 2*static_cast<int>(std::ceil(3*level_sigma))+1;
+                    pandora::image32f blurred_image(image_width,image_height,1,1,0);
+                    pandora::basic_gaussian_simd_filter<float>(image_width,image_height,kernel_diameter,level_sigma)(input_image,blurred_image);
+                    
+                    double error = 0;
+                    for (int y = 0; y < image_height; ++y)
+                    {
+                        for (int x = 0; x < image_width; ++x)
+                        {
+                            error += std::abs(scale_space.level(i)(x,y) - blurred_image(x,y));
+                        }
+                    }
+                    REQUIRE(error/(image_width*image_height) < 0.5);
+                }
+            }
+        }
+    }
+}
+
+SCENARIO("unsharp mask sharpening", "[gaussian][filter][unsharp]")
+{
+    GIVEN("Noisy images, one wide enough to be tiled in columns")
+    {
+        std::default_random_engine generator;
+        std::uniform_int_distribution<int> dist(0,255);
+        
+        const int sizes[][2] = {{320,240},{37,5},{10000,12}};
+        constexpr int kernel_diameter = 7;
+        constexpr float sigma = 1.5f;
+        constexpr float amount = 1.5f;
+        
+        WHEN("sharpen the images with and without a threshold")
+        {
+            THEN("the output should be the input plus the amount of its difference with the blurred input")
+            {
+                for (const auto& size : sizes)
+                {
+                    pandora::image8u input_image(size[0],size[1],1,2,0);
+                    for (auto& pixel_value : input_image)
+                    {
+                        pixel_value = static_cast<pandora::image8u::value_type>(dist(generator));
+                    }
+                    pandora::image8u blurred_image(size[0],size[1],1,2,0);
+                    pandora::gaussian_simd_filter(size[0],size[1],kernel_diameter,sigma)(input_image,blurred_image);
+                    
+                    for (auto level : {pandora::simd_level::scalar,pandora::simd_level::sse41,pandora::simd_level::avx2})
+                    {
+                        for (float threshold : {0.f,20.f})
+                        {
+                            pandora::image8u output_image(size[0],size[1],1,2,0);
+                            pandora::unsharp_mask_filter(kernel_diameter,sigma,amount,threshold,level)(input_image,output_image);
+                            
+                            for (int c = 0; c < 2; ++c)
+                            {
+                                for (int y = 0; y < size[1]; ++y)
+                                {
+                                    for (int x = 0; x < size[0]; ++x)
+                                    {
+                                        const int value = input_image(x,y,0,c);
+                                        const int difference = value - blurred_image(x,y,0,c);
+                                        const float sharpened = std::abs(difference) >= threshold ? value + amount*difference : value;
+                                        const int expected = static_cast<int>(std::max(0.f,std::min(255.f,sharpened + 0.5f)));
+                                        if (output_image(x,y,0,c) != expected)
+                                        {
+                                            FAIL("level " << static_cast<int>(level) << " threshold " << threshold << " pixel " << x << "," << y << "," << c);
+                                        }
+                                    }
+                                }
+                            }
+                        }
+                    }
+                }
+            }
+            
+            THEN("a null amount should leave the image unchanged")
+            {
+                pandora::image8u input_image(320,240,1,1,0);
+                for (auto& pixel_value : input_image)
+                {
+                    pixel_value = static_cast<pandora::image8u::value_type>(dist(generator));
+                }
+                pandora::image8u output_image(320,240,1,1,0);
+                pandora::unsharp_mask_filter(kernel_diameter,sigma,0.f)(input_image,output_image);
+                REQUIRE(output_image == input_image);
+            }
+            
+            THEN("a floating point image should be sharpened without saturation")
+            {
+                pandora::image32f input_image(320,240,1,1,0);
+                for (auto& pixel_value : input_image)
+                {
+                    pixel_value = static_cast<float>(dist(generator));
+                }
+                pandora::image32f blurred_image(320,240,1,1,0);
+                pandora::basic_gaussian_simd_filter<float>(320,240,kernel_diameter,sigma)(input_image,blurred_image);
+                
+                pandora::image32f output_image(320,240,1,1,0);
+                pandora::basic_unsharp_mask_filter<float>(kernel_diameter,sigma,amount)(input_image,output_image);
+                
+                pandora::image32f expected_image = input_image + amount*(input_image - blurred_image);
+                for (int y = 0; y < 240; ++y)
+                {
+                    for (int x = 0; x < 320; ++x)
+                    {
+                        REQUIRE(output_image(x,y) == Approx(expected_image(x,y)).margin(1e-3));
+                    }
+                }
+            }
+        }
+    }
+}